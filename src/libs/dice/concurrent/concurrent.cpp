@@ -0,0 +1,332 @@
+#include "concurrent.hpp"
+
+/*!
+    \addtogroup Concurrent_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+/*!
+    \brief Стандартный конструктор
+    \details Создаёт пустую группу.
+*/
+ConcurrentDice::ConcurrentDice()
+{
+}
+
+/*!
+    \brief Конструктор с кол-вом костей
+    \details Создаёт группу из dice_count "честных" костей и бросает их.
+
+    \param[in] dice_count кол-во костей.
+*/
+ConcurrentDice::ConcurrentDice(const size_t dice_count)
+{
+    allocate(dice_count);
+    for (size_t i = 0; i < size; ++i)
+    {
+        handles[i].store(fair_odds_handle, std::memory_order_relaxed);
+        values[i].store(1, std::memory_order_relaxed);
+        Shard &shard = shards[i / concurrent_shard_size];
+        ++shard.counts[1];
+        ++shard.sum;
+    }
+    (*this)();
+}
+
+/*!
+    \brief Конструктор из группы костей
+    \details Копирует значения и шансы костей из dice.
+
+    \param[in] dice ссылка на группу костей.
+*/
+ConcurrentDice::ConcurrentDice(const Dice &dice)
+{
+    allocate(dice.get_size());
+    const PackedNumPoints *dice_values = dice.get_values();
+    const OddsHandle *dice_handles = dice.get_odds_handles();
+    for (size_t i = 0; i < size; ++i)
+    {
+        handles[i].store(dice_handles[i], std::memory_order_relaxed);
+        values[i].store(dice_values[i], std::memory_order_relaxed);
+        Shard &shard = shards[i / concurrent_shard_size];
+        ++shard.counts[dice_values[i]];
+        shard.sum += dice_values[i];
+    }
+}
+
+/*!
+    \brief Выделение памяти
+    \details Выделяет ячейки под dice_count костей и части группы.
+
+    \param[in] dice_count кол-во костей.
+*/
+void ConcurrentDice::allocate(const size_t dice_count)
+{
+    size = dice_count;
+    shard_count = (dice_count + concurrent_shard_size - 1) / concurrent_shard_size;
+    values.reset(new std::atomic<PackedNumPoints>[dice_count]);
+    handles.reset(new std::atomic<OddsHandle>[dice_count]);
+    shards.reset(new Shard[shard_count]);
+}
+
+/*!
+    \brief Запись значения кости
+    \details Записывает значение value кости index и обновляет сумму и кол-ва значений части shard. Мьютекс части
+   должен быть захвачен.
+
+    \param[in] shard ссылка на часть группы, содержащую кость.
+    \param[in] index номер кости.
+    \param[in] value новое значение.
+*/
+void ConcurrentDice::store_value(Shard &shard, const size_t index, const NumPoints value) noexcept
+{
+    PackedNumPoints old_value = values[index].load(std::memory_order_relaxed);
+    --shard.counts[old_value];
+    ++shard.counts[value];
+    shard.sum += value;
+    shard.sum -= old_value;
+    values[index].store(static_cast<PackedNumPoints>(value), std::memory_order_release);
+}
+
+/*!
+    \brief Бросок части группы
+    \details Бросает все кости части shard_index под её мьютексом. Подряд идущие кости с одинаковыми шансами
+   бросаются одним вызовом.
+
+    \param[in] shard_index номер части группы.
+*/
+void ConcurrentDice::roll_shard(const size_t shard_index)
+{
+    NumPoints faces[concurrent_shard_size];
+    Shard &shard = shards[shard_index];
+    size_t first = shard_index * concurrent_shard_size;
+    size_t end = std::min(first + concurrent_shard_size, size);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    while (first < end)
+    {
+        OddsHandle handle = handles[first].load(std::memory_order_relaxed);
+        size_t last = first + 1;
+        while (last < end && handles[last].load(std::memory_order_relaxed) == handle)
+            ++last;
+        random_odds<OneDice::faces>(handle, faces, last - first);
+        for (size_t i = first; i < last; ++i)
+            store_value(shard, i, faces[i - first]);
+        first = last;
+    }
+}
+
+/*!
+    \brief Геттер размера группы
+    \return Кол-во костей в группе.
+*/
+size_t ConcurrentDice::get_size() const noexcept
+{
+    return size;
+}
+
+/*!
+    \brief Геттер значения кости
+    \details Читает значение без блокировок.
+
+    \param[in] index номер кости.
+
+    \return Значение кости.
+
+    \throw std::out_of_range - если номер кости больше или равен кол-ву костей.
+*/
+NumPoints ConcurrentDice::get_value(const size_t index) const
+{
+    if (index >= size)
+        throw std::out_of_range("Index out of range!");
+    return values[index].load(std::memory_order_acquire);
+}
+
+/*!
+    \brief Геттер номера шансов кости
+    \param[in] index номер кости.
+
+    \return Номер шансов кости в реестре.
+
+    \throw std::out_of_range - если номер кости больше или равен кол-ву костей.
+*/
+OddsHandle ConcurrentDice::get_odds_handle(const size_t index) const
+{
+    if (index >= size)
+        throw std::out_of_range("Index out of range!");
+    return handles[index].load(std::memory_order_acquire);
+}
+
+/*!
+    \brief Сеттер шансов кости
+    \details Меняет шансы кости index под мьютексом её части, поэтому одновременный переброс этой кости использует
+   либо старые, либо новые шансы целиком.
+
+    \param[in] index номер кости.
+    \param[in] odds ссылка на шансы выпадения граней.
+
+    \throw std::out_of_range - если номер кости больше или равен кол-ву костей.
+*/
+void ConcurrentDice::set_odds(const size_t index, const Odds &odds)
+{
+    if (index >= size)
+        throw std::out_of_range("Index out of range!");
+    OddsHandle handle = OddsRegistry<OneDice::faces>::intern(odds);
+    std::lock_guard<std::mutex> lock(shards[index / concurrent_shard_size].mutex);
+    handles[index].store(handle, std::memory_order_release);
+}
+
+/*!
+    \brief Переброс кости
+    \details Бросает кость index под мьютексом её части одиночным броском, без пакетной генерации. Перебросы костей
+   из разных частей не ждут друг друга.
+
+    \param[in] index номер кости.
+
+    \return Новое значение кости.
+
+    \throw std::out_of_range - если номер кости больше или равен кол-ву костей.
+*/
+NumPoints ConcurrentDice::reroll(const size_t index)
+{
+    if (index >= size)
+        throw std::out_of_range("Index out of range!");
+    Shard &shard = shards[index / concurrent_shard_size];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    NumPoints value = random_odds<OneDice::faces>(handles[index].load(std::memory_order_relaxed));
+    store_value(shard, index, value);
+    return value;
+}
+
+/*!
+    \brief Переброс костей по списку номеров
+    \details Перебрасывает кости с номерами из диапазона first..last - 1. Мьютекс части держится, пока подряд идущие
+   номера относятся к ней, поэтому упорядоченный список захватывает каждую часть один раз. Подряд идущие номера
+   костей части с одинаковыми шансами бросаются одним вызовом, как в roll_shard. Номера проверяются до переброса.
+
+    \param[in] first указатель на первый номер.
+    \param[in] last указатель за последним номером.
+
+    \throw std::out_of_range - если какой-либо номер больше или равен кол-ву костей.
+*/
+void ConcurrentDice::reroll(const size_t *first, const size_t *last)
+{
+    for (const size_t *index = first; index < last; ++index)
+        if (*index >= size)
+            throw std::out_of_range("Index out of range!");
+    NumPoints faces[concurrent_shard_size];
+    while (first < last)
+    {
+        size_t shard_index = *first / concurrent_shard_size;
+        Shard &shard = shards[shard_index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        while (first < last && *first / concurrent_shard_size == shard_index)
+        {
+            OddsHandle handle = handles[*first].load(std::memory_order_relaxed);
+            const size_t *run = first + 1;
+            while (run < last && static_cast<size_t>(run - first) < concurrent_shard_size &&
+                   *run / concurrent_shard_size == shard_index &&
+                   handles[*run].load(std::memory_order_relaxed) == handle)
+                ++run;
+            size_t count = static_cast<size_t>(run - first);
+            if (count == 1)
+                faces[0] = random_odds<OneDice::faces>(handle);
+            else
+                random_odds<OneDice::faces>(handle, faces, count);
+            for (size_t i = 0; i < count; ++i)
+                store_value(shard, first[i], faces[i]);
+            first = run;
+        }
+    }
+}
+
+/*!
+    \brief Перегрузка оператора ()
+    \details Бросает все кости группы, часть за частью. Броски отдельных костей из других потоков могут идти
+   одновременно.
+*/
+void ConcurrentDice::operator()()
+{
+    for (size_t i = 0; i < shard_count; ++i)
+        roll_shard(i);
+}
+
+/*!
+    \brief Снимок группы
+    \details Захватывает мьютексы всех частей по порядку и складывает их суммы и кол-ва значений. Перебросы держат
+   только один мьютекс, поэтому взаимоблокировки нет.
+
+    \return Согласованный снимок суммы и кол-ва костей с каждым значением.
+*/
+DiceSnapshot ConcurrentDice::snapshot() const
+{
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(shard_count);
+    DiceSnapshot result;
+    result.size = size;
+    for (size_t i = 0; i < shard_count; ++i)
+    {
+        locks.emplace_back(shards[i].mutex);
+        result.sum += shards[i].sum;
+        for (size_t face = 0; face <= OneDice::faces; ++face)
+            result.counts[face] += shards[i].counts[face];
+    }
+    return result;
+}
+
+/*!
+    \brief Сумма значений
+    \return Сумма значений всех костей в согласованном снимке.
+*/
+std::uint64_t ConcurrentDice::sum() const
+{
+    return snapshot().sum;
+}
+
+/*!
+    \brief Копия группы
+    \details Копирует значения и шансы всех костей под мьютексами всех частей.
+
+    \return Согласованная копия группы костей.
+*/
+Dice ConcurrentDice::to_Dice() const
+{
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i)
+        locks.emplace_back(shards[i].mutex);
+    std::vector<PackedNumPoints> copy(size);
+    for (size_t i = 0; i < size; ++i)
+        copy[i] = values[i].load(std::memory_order_relaxed);
+    Dice dice(copy.data(), copy.data() + size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        OddsHandle handle = handles[i].load(std::memory_order_relaxed);
+        if (handle != fair_odds_handle)
+            dice[i].set_odds_handle(handle);
+    }
+    return dice;
+}
+
+/*!
+    \brief Перегрузка оператора []
+    \details Значение и номер шансов читаются без блокировок по отдельности, реестр шансов не блокируется. Для
+   согласованной копии всей группы служит to_Dice().
+
+    \param[in] index номер кости.
+
+    \return Копия кости.
+
+    \throw std::out_of_range - если номер кости больше или равен кол-ву костей.
+*/
+OneDice ConcurrentDice::operator[](const size_t index) const
+{
+    OneDice dice(get_value(index));
+    dice.set_odds_handle(get_odds_handle(index));
+    return dice;
+}
+
+/*! @} */
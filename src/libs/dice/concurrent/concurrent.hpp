@@ -0,0 +1,85 @@
+/*!
+    \defgroup Concurrent_submodule Общая группа костей
+    \ingroup Dice_module
+    \brief Группа костей для одновременной работы из нескольких потоков
+*/
+#ifndef CONCURRENT_HPP
+#define CONCURRENT_HPP
+
+/*!
+    \addtogroup Concurrent_submodule
+    @{
+*/
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "../dice.hpp"
+
+constexpr size_t concurrent_shard_size = 1024; ///< Кол-во костей в одной части группы
+
+/*!
+    \brief Снимок группы костей
+    \details Сумма и кол-во костей с каждым значением в один момент времени.
+*/
+struct DiceSnapshot
+{
+        std::uint64_t size = 0;                          ///< Кол-во костей
+        std::uint64_t sum = 0;                           ///< Сумма значений
+        std::uint64_t counts[OneDice::faces + 1] = {};   ///< Кол-во костей с каждым значением
+};
+
+/*!
+    \brief Класс общей группы костей
+    \details Объект ConcurrentDice хранит значения и шансы костей в атомарных ячейках, поэтому значение отдельной кости
+   читается без блокировок. Группа разбита на части по concurrent_shard_size костей, у каждой части свой мьютекс,
+   сумма и кол-во костей с каждым значением. Перебросы костей из разных частей идут параллельно. Снимок блокирует все
+   части по порядку и поэтому согласован: он не видит половину переброса.
+*/
+class ConcurrentDice
+{
+    private:
+        struct alignas(64) Shard
+        {
+                std::mutex mutex;
+                std::uint64_t sum = 0;
+                std::uint64_t counts[OneDice::faces + 1] = {};
+        };
+
+        size_t size = 0;
+        size_t shard_count = 0;
+        std::unique_ptr<std::atomic<PackedNumPoints>[]> values;
+        std::unique_ptr<std::atomic<OddsHandle>[]> handles;
+        std::unique_ptr<Shard[]> shards;
+
+        void allocate(const size_t dice_count);
+        void store_value(Shard &shard, const size_t index, const NumPoints value) noexcept;
+        void roll_shard(const size_t shard_index);
+
+    public:
+        ConcurrentDice();
+        ConcurrentDice(const size_t dice_count);
+        ConcurrentDice(const Dice &dice);
+        ConcurrentDice(const ConcurrentDice &other) = delete;
+        ConcurrentDice &operator=(const ConcurrentDice &other) = delete;
+
+        size_t get_size() const noexcept;
+        NumPoints get_value(const size_t index) const;
+        OddsHandle get_odds_handle(const size_t index) const;
+        void set_odds(const size_t index, const Odds &odds);
+
+        NumPoints reroll(const size_t index);
+        void reroll(const size_t *first, const size_t *last);
+        void operator()();
+
+        DiceSnapshot snapshot() const;
+        std::uint64_t sum() const;
+        Dice to_Dice() const;
+
+        OneDice operator[](const size_t index) const;
+};
+
+/*! @} */
+
+#endif // CONCURRENT_HPP
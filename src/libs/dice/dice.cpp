@@ -1,12 +1,187 @@
 #include "dice.hpp"
+#include "./journal/journal.hpp"
 
 /*!
     \addtogroup Dice_module
     @{
 */
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <numeric>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+constexpr size_t roll_block = 256;                  ///< Максимальное кол-во костей в одном пакетном броске
+constexpr size_t parallel_chunk = size_t(1) << 16; ///< Кол-во костей в части группы при параллельном броске
+constexpr size_t input_reserve = size_t(1) << 16;  ///< Сколько костей оператор ввода резервирует заранее
+
+/*!
+    \brief Конструктор ссылки
+    \details Создаёт ссылку на кость с индексом index в объекте dice.
+
+    \param[in] dice указатель на объект Dice.
+    \param[in] index индекс кости.
+*/
+OneDiceRef::OneDiceRef(Dice *dice, const size_t index) noexcept : dice(dice), index(index)
+{
+}
+
+/*!
+    \brief Сеттер шансов выпадения
+    \details Меняет шансы выпадения граней кости.
+
+    \param[in] input_odds ссылка на объект класса Odds.
+
+    \throw std::invalid_argument - если сумма шансов равна 0 или слишком велика.
+    \throw std::length_error - если реестр шансов переполнен.
+*/
+void OneDiceRef::set_odds(const Odds &input_odds)
+{
+    dice->store_handle(index, OddsRegistry<OneDice::faces>::intern(input_odds));
+}
+
+/*!
+    \brief Сеттер номера шансов
+    \details Меняет шансы выпадения граней кости на шансы с номером handle из реестра.
+
+    \param[in] handle номер шансов в реестре.
+
+    \throw std::out_of_range - если в реестре нет шансов с номером handle.
+*/
+void OneDiceRef::set_odds_handle(const OddsHandle handle)
+{
+    if (handle >= OddsRegistry<OneDice::faces>::get_size())
+        throw std::out_of_range("Unknown odds handle!");
+    dice->store_handle(index, handle);
+}
+
+/*!
+    \brief Сеттер значения кости
+    \details Меняет значение кости.
+
+    \param[in] value значение кости.
+
+    \throw std::invalid_argument - если value не может являться значением кости.
+*/
+void OneDiceRef::set_value(const NumPoints value)
+{
+    if (!check_NumPoints<OneDice::faces>(value))
+        throw std::invalid_argument("Invalid value!");
+    dice->store_value(index, value);
+}
+
+/*!
+    \brief Геттер значения кости
+    \details Возвращает значение кости.
+
+    \return Значение кости.
+*/
+NumPoints OneDiceRef::get_value() const noexcept
+{
+    return dice->values.get_data()[index];
+}
+
+/*!
+    \brief Геттер AsciiArt
+    \details Возвращает значение кости в виде объекта AsciiArt.
+
+    \return Значение кости в виде объекта AsciiArt.
+*/
+AsciiArt OneDiceRef::get_value_AsciiArt() const
+{
+    return OneDice(*this).get_value_AsciiArt();
+}
+
+/*!
+    \brief Геттер шансов выпадения
+    \details Возвращает копию шансов выпадения граней кости из реестра.
+
+    \return Шансы выпадения граней кости.
+*/
+Odds OneDiceRef::get_odds() const
+{
+    return OddsRegistry<OneDice::faces>::get_odds(get_odds_handle());
+}
+
+/*!
+    \brief Геттер номера шансов
+    \details Возвращает номер шансов выпадения граней кости в реестре.
+
+    \return Номер шансов в реестре.
+*/
+OddsHandle OneDiceRef::get_odds_handle() const noexcept
+{
+    return dice->handles.get_data()[index];
+}
+
+/*!
+    \brief Бросок кости
+    \details Бросает кость так же, как оператор () группы для индекса кости.
+
+    \return Новое значение кости.
+*/
+NumPoints OneDiceRef::to_change_value()
+{
+    return (*dice)(index);
+}
+
+/*!
+    \brief Оператор приведения к OneDice
+    \details Создаёт объект OneDice с теми же значением и шансами, что и у кости.
+
+    \return Копию кости.
+*/
+OneDiceRef::operator OneDice() const
+{
+    OneDice result(get_value());
+    result.set_odds_handle(get_odds_handle());
+    return result;
+}
+
+/*!
+    \brief Оператор ==
+    \details Перегрузка оператора == для сравнения кости с объектом OneDice.
+
+    \param[in] other ссылка на объект OneDice.
+
+    \return True если значения и шансы совпадают. Иначе False.
+*/
+bool OneDiceRef::operator==(const OneDice &other) const
+{
+    return get_value() == other.get_value() && get_odds_handle() == other.get_odds_handle();
+}
+
+/*!
+    \brief Оператор присваивания
+    \details Записывает значение и шансы other в кость группы.
+
+    \param[in] other ссылка на объект OneDice.
+
+    \return Ссылку на текущий объект.
+*/
+OneDiceRef &OneDiceRef::operator=(const OneDice &other)
+{
+    dice->store_value(index, other.get_value());
+    dice->store_handle(index, other.get_odds_handle());
+    return *this;
+}
+
+/*!
+    \brief Оператор присваивания
+    \details Записывает значение и шансы кости other в кость группы.
+
+    \param[in] other ссылка на другую кость группы.
+
+    \return Ссылку на текущий объект.
+*/
+OneDiceRef &OneDiceRef::operator=(const OneDiceRef &other)
+{
+    return *this = OneDice(other);
+}
 
 /*!
     \brief Стандартный конструктор
@@ -40,56 +215,205 @@ Dice::Dice(Dice &&other)
 
 /*!
     \brief Конструктор с кол-вом костей
-    \details Создаёт объект класса Dice и заполнет size костями со случайным значением.
+    \details Создаёт объект класса Dice и заполнет size "честными" костями со случайным значением.
 
     \param[in] size кол-во костей.
 */
-Dice::Dice(const size_t size)
+Dice::Dice(const size_t size) : values(size), handles(size)
 {
-    arr = Vector<OneDice>(size);
+    std::fill(handles.get_data(), handles.get_data() + size, fair_odds_handle);
+    add_moments(fair_odds_handle, static_cast<double>(size));
+    (*this)();
+}
+
+/*!
+    \brief Проверка значений костей
+    \details Проверяет, что каждое значение из диапазона first..last может являться значением кости. Проверка идёт без
+   ветвлений, поэтому компилятор векторизует её.
+
+    \tparam T тип значения.
+
+    \param[in] first указатель на первое значение.
+    \param[in] last указатель на конец диапазона.
+
+    \throw std::invalid_argument - если в диапазоне есть значение, которое не может являться значением кости.
+*/
+template <typename T> void check_values(const T *first, const T *last)
+{
+    bool invalid = false;
+    for (const T *value = first; value != last; ++value)
+        invalid |= static_cast<T>(*value - 1) >= static_cast<T>(OneDice::faces);
+    if (invalid)
+        throw std::invalid_argument("Invalid value!");
+}
+
+/*!
+    \brief Длина диапазона
+    \details Вычисляет кол-во значений в диапазоне first..last.
+
+    \tparam T тип значения.
+
+    \param[in] first указатель на первое значение.
+    \param[in] last указатель на конец диапазона.
+
+    \return Кол-во значений в диапазоне.
+
+    \throw std::invalid_argument - если first > last.
+*/
+template <typename T> size_t range_size(const T *first, const T *last)
+{
+    if (first > last)
+        throw std::invalid_argument("Invalid range");
+    return static_cast<size_t>(last - first);
 }
 
 /*!
     \brief Конструктор со значениями костей
-    \details Создаёт объект класса Dice и заполняет его костями со значениями из input_vector.
+    \details Создаёт объект класса Dice и заполняет его "честными" костями со значениями из input_vector без бросков.
 
     \param[in] input_vector ссылка на вектор содержащий значения костей.
+
+    \throw std::invalid_argument - если в input_vector есть значение, которое не может являться значением кости.
 */
 Dice::Dice(const Vector<NumPoints> &input_vector)
+    : Dice(input_vector.get_data(), input_vector.get_data() + input_vector.get_size())
+{
+}
+
+/*!
+    \brief Конструктор с диапазоном значений
+    \details Создаёт объект класса Dice и заполняет его "честными" костями со значениями из диапазона first..last без
+   бросков и промежуточных копий.
+
+    \param[in] first указатель на первое значение.
+    \param[in] last указатель на конец диапазона.
+
+    \throw std::invalid_argument - если first > last или в диапазоне есть значение, которое не может являться
+   значением кости.
+*/
+Dice::Dice(const NumPoints *first, const NumPoints *last)
+    : values(range_size(first, last)), handles(range_size(first, last))
+{
+    check_values(first, last);
+    std::copy(first, last, values.get_data());
+    std::fill(handles.get_data(), handles.get_data() + get_size(), fair_odds_handle);
+    count_values();
+    add_moments(fair_odds_handle, static_cast<double>(get_size()));
+}
+
+/*!
+    \brief Конструктор с диапазоном упакованных значений
+    \details Создаёт объект класса Dice и заполняет его "честными" костями со значениями из диапазона first..last.
+   Значения копируются в массив значений одним блоком.
+
+    \param[in] first указатель на первое значение.
+    \param[in] last указатель на конец диапазона.
+
+    \throw std::invalid_argument - если first > last или в диапазоне есть значение, которое не может являться
+   значением кости.
+*/
+Dice::Dice(const PackedNumPoints *first, const PackedNumPoints *last)
+    : values(range_size(first, last)), handles(range_size(first, last))
 {
-    arr = Vector<OneDice>(input_vector.get_size());
-    Vector<NumPoints>::iterator iter = input_vector.cbegin();
-    std::for_each(arr.begin(), arr.end(),
-                  [&iter](OneDice &dice)
-                  {
-                      dice.set_value(*iter);
-                      ++iter;
-                  });
+    check_values(first, last);
+    std::copy(first, last, values.get_data());
+    std::fill(handles.get_data(), handles.get_data() + get_size(), fair_odds_handle);
+    count_values();
+    add_moments(fair_odds_handle, static_cast<double>(get_size()));
 }
 
 /*!
     \brief Геттер размера
-    \details Возвращает размер вектора костей.
+    \details Возвращает кол-во костей.
 
-    \return Размер вектора костей.
+    \return Кол-во костей.
 */
 size_t Dice::get_size() const noexcept
 {
-    return arr.get_size();
+    return values.get_size();
 }
 
 /*!
     \brief Геттер AsciiArt
     \details Возвращает значения костей в виде объекта AsciiArt.
 
-    \return Размер вектора костей.
+    \return Значения костей в виде объекта AsciiArt.
 */
 AsciiArt Dice::get_AsciiArt() const noexcept
 {
     if (get_size() == 0)
         return AsciiArt();
-    return std::accumulate(arr.cbegin() + 1, arr.cend(), (*(arr.cbegin())).get_value_AsciiArt(),
-                           [](AsciiArt &a, const OneDice &b) { return a + b.get_value_AsciiArt(); });
+    const PackedNumPoints *value = values.get_data();
+    return std::accumulate(value + 1, value + get_size(), OneDice(*value).get_value_AsciiArt(),
+                           [](AsciiArt a, const PackedNumPoints b) { return a + OneDice(b).get_value_AsciiArt(); });
+}
+
+/*!
+    \brief Геттер значений
+    \details Возвращает указатель на плотный массив значений костей длины get_size().
+
+    \return Указатель на массив значений костей.
+*/
+const PackedNumPoints *Dice::get_values() const noexcept
+{
+    return values.get_data();
+}
+
+/*!
+    \brief Геттер номеров шансов
+    \details Возвращает указатель на массив номеров шансов костей в реестре длины get_size().
+
+    \return Указатель на массив номеров шансов.
+*/
+const OddsHandle *Dice::get_odds_handles() const noexcept
+{
+    return handles.get_data();
+}
+
+/*!
+    \brief Сеттер значений
+    \details Меняет значения всех костей на значения из диапазона first..last, сохраняя шансы выпадения. Значения
+   копируются одним блоком.
+
+    \param[in] first указатель на первое значение.
+    \param[in] last указатель на конец диапазона.
+
+    \throw std::invalid_argument - если длина диапазона не равна кол-ву костей или в диапазоне есть значение, которое
+   не может являться значением кости.
+*/
+void Dice::set_values(const PackedNumPoints *first, const PackedNumPoints *last)
+{
+    if (range_size(first, last) != get_size())
+        throw std::invalid_argument("Invalid range");
+    check_values(first, last);
+    std::copy(first, last, values.get_data());
+    count_values();
+}
+
+/*!
+    \brief Загрузка значений
+    \details Заменяет все кости "честными" костями со значениями из input_values. Массив значений забирается без
+   копирования. Значения проверяются тем же проходом, которым считается кол-во костей с каждым значением.
+
+    \param[in] input_values перемещающая ссылка на вектор значений.
+
+    \throw std::invalid_argument - если в input_values есть значение, которое не может являться значением кости.
+*/
+void Dice::load_values(Vector<PackedNumPoints> &&input_values)
+{
+    size_t input_counts[OneDice::faces + 1] = {};
+    count_faces(input_values.get_data(), input_values.get_size(), OneDice::faces, input_counts);
+    if (std::accumulate(input_counts + 1, input_counts + OneDice::faces + 1, size_t(0)) != input_values.get_size())
+        throw std::invalid_argument("Invalid value!");
+    values = std::move(input_values);
+    handles = Vector<OddsHandle>(get_size());
+    std::fill(handles.get_data(), handles.get_data() + get_size(), fair_odds_handle);
+    moments = OddsMoments();
+    add_moments(fair_odds_handle, static_cast<double>(get_size()));
+    std::copy(input_counts, input_counts + OneDice::faces + 1, counts);
+    total = 0;
+    for (size_t face = 1; face <= OneDice::faces; ++face)
+        total += face * counts[face];
 }
 
 /*!
@@ -106,20 +430,343 @@ bool Dice::has_NumPoints(const NumPoints value) const
 {
     if (!check_NumPoints(value))
         throw std::invalid_argument("Uncorrect argument value!");
-    return std::find_if(arr.cbegin(), arr.cend(),
-                        [&value](const OneDice &dice) { return dice.get_value() == value; }) != arr.cend();
+    return counts[value] != 0;
+}
+
+/*!
+    \brief Кол-во костей с определённым значением
+    \details Возвращает кол-во костей со значением value в текущем объекте.
+
+    \param[in] value значение кости.
+
+    \return Кол-во костей со значением value.
+
+    \throw std::invalid_argument - если value не может являться значением кости.
+*/
+size_t Dice::count_NumPoints(const NumPoints value) const
+{
+    if (!check_NumPoints(value))
+        throw std::invalid_argument("Uncorrect argument value!");
+    return counts[value];
 }
 
 /*!
     \brief Сумма значений костей
-    \details Суммируте значения костей.
+    \details Возвращает 64-битную сумму значений костей, которая обновляется при каждом изменении костей.
 
     \return Сумму значений костей.
 */
-NumPoints Dice::sum() const noexcept
+std::uint64_t Dice::sum() const noexcept
+{
+    return total;
+}
+
+/*!
+    \brief Геттер моментов
+    \details Моменты суммы значений поддерживаются при добавлении и удалении костей и смене их шансов, поэтому
+   геттер работает за O(1).
+
+    \return Математическое ожидание, дисперсия и кумулянты третьего и четвёртого порядка суммы значений.
+*/
+OddsMoments Dice::get_moments() const noexcept
+{
+    return moments;
+}
+
+/*!
+    \brief Математическое ожидание суммы
+    \return Математическое ожидание суммы значений после броска всех костей.
+*/
+double Dice::mean() const noexcept
+{
+    return moments.mean;
+}
+
+/*!
+    \brief Дисперсия суммы
+    \return Дисперсия суммы значений после броска всех костей.
+*/
+double Dice::variance() const noexcept
+{
+    return moments.variance;
+}
+
+/*!
+    \brief Квантиль суммы
+    \details Приближает квантиль суммы значений после броска всех костей по моментам за O(1) без бросков.
+
+    \param[in] p вероятность.
+    \param[in] method способ приближения.
+
+    \return Приближённое значение x, для которого P(сумма <= x) = p.
+
+    \throw std::invalid_argument - если p не лежит в интервале (0, 1).
+*/
+double Dice::quantile(const double p, const QuantileMethod method) const
+{
+    return approximate_quantile(moments, p, method);
+}
+
+/*!
+    \brief Подсчёт значений
+    \details Заново вычисляет кол-во костей с каждым значением и сумму значений за один проход по массиву значений.
+*/
+void Dice::count_values() noexcept
 {
-    return std::accumulate(arr.cbegin(), arr.cend(), 0,
-                           [](const NumPoints &a, const OneDice &b) { return a + b.get_value(); });
+    std::fill(counts, counts + OneDice::faces + 1, 0);
+    count_faces(values.get_data(), get_size(), OneDice::faces, counts);
+    total = 0;
+    for (size_t face = 1; face <= OneDice::faces; ++face)
+        total += face * counts[face];
+}
+
+/*!
+    \brief Подсчёт моментов
+    \details Пересчитывает моменты суммы значений по шансам всех костей. Моменты подряд идущих костей с одинаковыми
+   шансами добавляются одним умножением.
+*/
+void Dice::count_moments()
+{
+    moments = OddsMoments();
+    const OddsHandle *handle = handles.get_data();
+    const size_t size = get_size();
+    size_t first = 0;
+    while (first < size)
+    {
+        size_t last = first + 1;
+        while (last < size && handle[last] == handle[first])
+            ++last;
+        add_moments(handle[first], static_cast<double>(last - first));
+        first = last;
+    }
+}
+
+/*!
+    \brief Добавление моментов
+    \details Добавляет к моментам суммы моменты count костей с шансами handle. Отрицательное count вычитает их.
+   Кумулянты независимых костей складываются, поэтому обновление работает за O(1).
+
+    \param[in] handle номер шансов в реестре.
+    \param[in] count кол-во костей.
+*/
+void Dice::add_moments(const OddsHandle handle, const double count)
+{
+    const OddsMoments &dice_moments = OddsRegistry<OneDice::faces>::get_moments(handle);
+    moments.mean += count * dice_moments.mean;
+    moments.variance += count * dice_moments.variance;
+    moments.third += count * dice_moments.third;
+    moments.fourth += count * dice_moments.fourth;
+}
+
+/*!
+    \brief Запись значения кости
+    \details Меняет значение кости с индексом index на value, обновляя кол-во костей с каждым значением и сумму.
+
+    \param[in] index индекс кости.
+    \param[in] value новое значение кости.
+*/
+void Dice::store_value(const size_t index, const NumPoints value) noexcept
+{
+    PackedNumPoints &stored = values.get_data()[index];
+    --counts[stored];
+    total -= stored;
+    stored = static_cast<PackedNumPoints>(value);
+    ++counts[stored];
+    total += stored;
+}
+
+/*!
+    \brief Запись шансов кости
+    \details Меняет шансы кости с индексом index на шансы с номером handle, обновляя моменты суммы.
+
+    \param[in] index индекс кости.
+    \param[in] handle номер шансов в реестре.
+*/
+void Dice::store_handle(const size_t index, const OddsHandle handle)
+{
+    if (handles[index] == handle)
+        return;
+    add_moments(handles[index], -1);
+    add_moments(handle, 1);
+    handles[index] = handle;
+}
+
+/*!
+    \brief Бросок подряд идущих костей
+    \details Генерирует значения count костей с одинаковыми шансами, начиная с кости с индексом first. Генератор на
+   счётчике использует текущую эпоху, иначе значения берутся из генератора потока.
+
+    \param[in] first индекс первой кости.
+    \param[in] count кол-во костей.
+    \param[in] handle номер шансов выпадения граней в реестре.
+    \param[out] faces указатель на массив для значений.
+*/
+void Dice::roll_range(const size_t first, const size_t count, const OddsHandle handle, NumPoints *faces) const
+{
+    if (counter_based)
+    {
+        RandomWord words[roll_block];
+        engine.fill(first, epoch, words, count);
+        words_to_faces<OneDice::faces>(handle, words, faces, count);
+    }
+    else
+        random_odds<OneDice::faces>(handle, faces, count);
+}
+
+/*!
+    \brief Сеттер генератора на счётчике
+    \details Включает бросок костей генератором на счётчике counter_engine. Номер последнего броска становится
+   равным start_epoch, следующий бросок получит номер start_epoch + 1.
+
+    \param[in] counter_engine ссылка на генератор на счётчике.
+    \param[in] start_epoch номер последнего броска.
+*/
+void Dice::set_CounterEngine(const CounterEngine &counter_engine, const std::uint32_t start_epoch)
+{
+    partial_epochs = Vector<std::uint32_t>();
+    partial_starts = Vector<size_t>();
+    partial_indices = Vector<size_t>();
+    engine = counter_engine;
+    counter_based = true;
+    epoch = start_epoch;
+}
+
+/*!
+    \brief Запись броска части костей
+    \details Запоминает, что в броске с текущим номером бросались только кости с индексами из диапазона first..last.
+   Индексы хранятся отсортированными без повторов.
+
+    \param[in] first указатель на первый индекс.
+    \param[in] last указатель на конец диапазона индексов.
+*/
+void Dice::record_partial(const size_t *first, const size_t *last)
+{
+    std::vector<size_t> sorted(first, last);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    partial_epochs.push_back(epoch);
+    partial_starts.push_back(partial_indices.get_size());
+    for (size_t index : sorted)
+        partial_indices.push_back(index);
+}
+
+/*!
+    \brief Проверка броска кости
+    \details Броски до установки генератора на счётчике (номера не больше start_epoch) и броски всех костей
+   считаются бросками каждой кости. Бросок части костей ищется двоичным поиском по номеру.
+
+    \param[in] index индекс кости.
+    \param[in] roll_epoch номер броска.
+
+    \return True если кость с индексом index бросалась в броске roll_epoch. Иначе False.
+*/
+bool Dice::was_rolled(const size_t index, const std::uint32_t roll_epoch) const
+{
+    if (roll_epoch == 0 || roll_epoch > epoch)
+        return false;
+    const std::uint32_t *epochs = partial_epochs.get_data();
+    const std::uint32_t *found = std::lower_bound(epochs, epochs + partial_epochs.get_size(), roll_epoch);
+    if (found == epochs + partial_epochs.get_size() || *found != roll_epoch)
+        return true;
+    size_t partial = static_cast<size_t>(found - epochs);
+    const size_t *indices = partial_indices.get_data();
+    size_t begin = partial_starts[partial];
+    size_t end = partial + 1 < partial_starts.get_size() ? partial_starts[partial + 1] : partial_indices.get_size();
+    return std::binary_search(indices + begin, indices + end, index);
+}
+
+/*!
+    \brief Сброс генератора на счётчике
+    \details Возвращает бросок костей генератору потока.
+*/
+void Dice::reset_CounterEngine() noexcept
+{
+    counter_based = false;
+}
+
+/*!
+    \brief Проверка генератора на счётчике
+    \details Проверяет, бросаются ли кости генератором на счётчике.
+
+    \return True если кости бросаются генератором на счётчике. Иначе False.
+*/
+bool Dice::is_counter_based() const noexcept
+{
+    return counter_based;
+}
+
+/*!
+    \brief Геттер генератора на счётчике
+    \details Возвращает генератор на счётчике.
+
+    \return Генератор на счётчике.
+*/
+CounterEngine Dice::get_CounterEngine() const noexcept
+{
+    return engine;
+}
+
+/*!
+    \brief Геттер эпохи
+    \details Возвращает номер последнего броска генератором на счётчике. Каждый бросок всех костей или одной кости
+   увеличивает его на 1.
+
+    \return Номер последнего броска.
+*/
+std::uint32_t Dice::get_epoch() const noexcept
+{
+    return epoch;
+}
+
+/*!
+    \brief Значение кости в броске
+    \details Вычисляет значение, которое кость с индексом index получила в броске с номером roll_epoch, не изменяя
+   кости. Номер должен быть уже сделанного броска, в котором эта кость бросалась: броски одной кости и reroll бросают
+   только часть костей, и для остальных костей их номер отклоняется. Броски с номером не больше start_epoch из
+   set_CounterEngine считаются бросками всех костей.
+
+    \param[in] index индекс кости.
+    \param[in] roll_epoch номер броска.
+
+    \return Значение кости в броске roll_epoch.
+
+    \throw std::out_of_range - если index выходит за границы вектора.
+    \throw std::logic_error - если генератор на счётчике не задан.
+    \throw std::invalid_argument - если кость не бросалась в броске roll_epoch или такого броска ещё не было.
+*/
+NumPoints Dice::get_roll(const size_t index, const std::uint32_t roll_epoch) const
+{
+    if (index >= get_size())
+        throw std::out_of_range("Index out of range");
+    if (!counter_based)
+        throw std::logic_error("Counter engine is not set!");
+    if (!was_rolled(index, roll_epoch))
+        throw std::invalid_argument("Dice was not rolled in this epoch!");
+    RandomWord word = engine.get_word(index, roll_epoch);
+    NumPoints value;
+    words_to_faces<OneDice::faces>(handles[index], &word, &value, 1);
+    return value;
+}
+
+/*!
+    \brief Повтор броска кости
+    \details Устанавливает кости с индексом index значение, полученное ей в броске с номером roll_epoch. Остальные
+   кости и номер последнего броска не изменяются.
+
+    \param[in] index индекс кости.
+    \param[in] roll_epoch номер броска.
+
+    \return Новое значение кости с индексом index.
+
+    \throw std::out_of_range - если index выходит за границы вектора.
+    \throw std::logic_error - если генератор на счётчике не задан.
+    \throw std::invalid_argument - если кость не бросалась в броске roll_epoch или такого броска ещё не было.
+*/
+NumPoints Dice::replay(const size_t index, const std::uint32_t roll_epoch)
+{
+    NumPoints value = get_roll(index, roll_epoch);
+    store_value(index, value);
+    return value;
 }
 
 /*!
@@ -132,7 +779,17 @@ NumPoints Dice::sum() const noexcept
 */
 Dice &Dice::operator=(const Dice &other)
 {
-    arr = other.arr;
+    values = other.values;
+    handles = other.handles;
+    engine = other.engine;
+    counter_based = other.counter_based;
+    epoch = other.epoch;
+    partial_epochs = other.partial_epochs;
+    partial_starts = other.partial_starts;
+    partial_indices = other.partial_indices;
+    std::copy(other.counts, other.counts + OneDice::faces + 1, counts);
+    total = other.total;
+    moments = other.moments;
     return *this;
 }
 
@@ -146,22 +803,148 @@ Dice &Dice::operator=(const Dice &other)
 */
 Dice &Dice::operator=(Dice &&other)
 {
-    arr = std::move(other.arr);
+    values = std::move(other.values);
+    handles = std::move(other.handles);
+    engine = other.engine;
+    counter_based = other.counter_based;
+    epoch = other.epoch;
+    partial_epochs = std::move(other.partial_epochs);
+    partial_starts = std::move(other.partial_starts);
+    partial_indices = std::move(other.partial_indices);
+    std::copy(other.counts, other.counts + OneDice::faces + 1, counts);
+    total = other.total;
+    moments = other.moments;
+    other.count_values();
+    other.count_moments();
     return *this;
 }
 
 /*!
     \brief Оператор ()
-    \details Перегрузка оператора (). Бросает все кости.
+    \details Перегрузка оператора (). Бросает все кости. Подряд идущие кости с одинаковыми шансами бросаются пакетно
+   блоками по roll_block. При генераторе на счётчике бросок получает следующий номер. Если включён журнал бросков,
+   значения всех костей записываются в него.
+*/
+void Dice::operator()()
+{
+    NumPoints faces[roll_block];
+    if (counter_based)
+        ++epoch;
+    const size_t size = get_size();
+    const OddsHandle *handle = handles.get_data();
+    PackedNumPoints *value = values.get_data();
+    size_t first = 0;
+    while (first < size)
+    {
+        size_t last = first + 1;
+        while (last < size && last - first < roll_block && handle[last] == handle[first])
+            ++last;
+        roll_range(first, last - first, handle[first], faces);
+        std::copy(faces, faces + (last - first), value + first);
+        first = last;
+    }
+    count_values();
+    journal_rolls(0, value, size, OneDice::faces);
+}
+
+/*!
+    \brief Бросок части группы
+    \details Бросает кости с индексами first..last - 1 генератором на счётчике chunk_engine в броске с номером
+   chunk_epoch и добавляет кол-во выпавших значений в chunk_counts. Результат зависит только от генератора, номера
+   броска и индексов костей.
+
+    \param[in] chunk_engine ссылка на генератор на счётчике.
+    \param[in] chunk_epoch номер броска.
+    \param[in] first индекс первой кости.
+    \param[in] last индекс за последней костью.
+    \param[in,out] chunk_counts указатель на массив кол-ва костей с каждым значением.
+*/
+void Dice::roll_chunk(const CounterEngine &chunk_engine, const std::uint32_t chunk_epoch, const size_t first,
+                      const size_t last, size_t *chunk_counts)
+{
+    RandomWord words[roll_block];
+    NumPoints faces[roll_block];
+    const OddsHandle *handle = handles.get_data();
+    PackedNumPoints *value = values.get_data();
+    size_t begin = first;
+    while (begin < last)
+    {
+        size_t end = begin + 1;
+        while (end < last && end - begin < roll_block && handle[end] == handle[begin])
+            ++end;
+        chunk_engine.fill(begin, chunk_epoch, words, end - begin);
+        words_to_faces<OneDice::faces>(handle[begin], words, faces, end - begin);
+        std::copy(faces, faces + (end - begin), value + begin);
+        begin = end;
+    }
+    count_faces(value + first, last - first, OneDice::faces, chunk_counts);
+}
+
+/*!
+    \brief Параллельный бросок
+    \details Бросает все кости в threads потоках. Группа делится на части по parallel_chunk костей, которые потоки
+   забирают по очереди. Значение каждой кости вычисляется генератором на счётчике по её индексу, поэтому результат
+   не зависит от кол-ва потоков. Если генератор на счётчике задан, бросок получает следующий номер. Иначе зерно
+   броска берётся из генератора текущего потока, и результат определяется его зерном.
+
+   Если поток не удалось запустить, его части бросают уже запущенные потоки.
+
+    \param[in] threads кол-во потоков, 0 - по кол-ву ядер.
 */
-void Dice::operator()() noexcept
+void Dice::roll_parallel(size_t threads)
 {
-    std::for_each(arr.begin(), arr.end(), [](OneDice &dice) { dice.to_change_value(); });
+    CounterEngine roll_engine = engine;
+    std::uint32_t roll_epoch = 0;
+    if (counter_based)
+        roll_epoch = ++epoch;
+    else
+        roll_engine = CounterEngine(static_cast<std::uint64_t>(random_word()) << 32 | random_word());
+
+    const size_t size = get_size();
+    const size_t chunks = (size + parallel_chunk - 1) / parallel_chunk;
+    if (threads == 0)
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    threads = std::min(threads, chunks);
+
+    std::atomic<size_t> next_chunk(0);
+    std::vector<std::vector<size_t>> thread_counts(std::max<size_t>(threads, 1),
+                                                   std::vector<size_t>(OneDice::faces + 1, 0));
+    auto worker = [this, &roll_engine, roll_epoch, &next_chunk, size](size_t *chunk_counts)
+    {
+        for (size_t chunk = next_chunk++; chunk * parallel_chunk < size; chunk = next_chunk++)
+            roll_chunk(roll_engine, roll_epoch, chunk * parallel_chunk,
+                       std::min(size, (chunk + 1) * parallel_chunk), chunk_counts);
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t)
+    {
+        try
+        {
+            workers.emplace_back(worker, thread_counts[t].data());
+        }
+        catch (const std::system_error &)
+        {
+            break;
+        }
+    }
+    worker(thread_counts[0].data());
+    for (std::thread &thread : workers)
+        thread.join();
+
+    std::fill(counts, counts + OneDice::faces + 1, 0);
+    total = 0;
+    for (const std::vector<size_t> &chunk_counts : thread_counts)
+        for (size_t face = 1; face <= OneDice::faces; ++face)
+            counts[face] += chunk_counts[face];
+    for (size_t face = 1; face <= OneDice::faces; ++face)
+        total += face * counts[face];
+    journal_rolls(0, values.get_data(), size, OneDice::faces);
 }
 
 /*!
     \brief Оператор ()
-    \details Перегрузка оператора (). Бросает кость с индексом index.
+    \details Перегрузка оператора (). Бросает кость с индексом index. При генераторе на счётчике бросок получает
+   следующий номер, и только для этой кости get_roll принимает его.
 
     \param[in] index индекс кости.
 
@@ -171,9 +954,113 @@ void Dice::operator()() noexcept
 */
 NumPoints Dice::operator()(const size_t index)
 {
-    if (index >= arr.get_size())
+    if (index >= get_size())
+        throw std::out_of_range("Index out of range");
+    NumPoints value;
+    if (counter_based)
+    {
+        ++epoch;
+        record_partial(&index, &index + 1);
+        value = replay(index, epoch);
+    }
+    else
+    {
+        value = random_odds<OneDice::faces>(handles[index]);
+        store_value(index, value);
+    }
+    journal_roll(index, value, OneDice::faces);
+    return value;
+}
+
+/*!
+    \brief Бросок выбранных костей
+    \details Бросает кости с индексами из indices. Подробнее в описании reroll(const size_t *, const size_t *).
+
+    \param[in] indices ссылка на вектор индексов костей.
+
+    \throw std::out_of_range - если какой-либо индекс выходит за границы вектора.
+*/
+void Dice::reroll(const Vector<size_t> &indices)
+{
+    reroll(indices.get_data(), indices.get_data() + indices.get_size());
+}
+
+/*!
+    \brief Бросок выбранных костей
+    \details Бросает кости с индексами из диапазона first..last. Сначала за один проход проверяются все индексы, и
+   при ошибке ни одна кость не меняется. Затем подряд идущие в списке кости с одинаковыми шансами бросаются пакетно
+   блоками по roll_block, как в операторе (). При генераторе на счётчике все кости бросаются в одном броске со
+   следующим номером, поэтому повторный индекс получает то же значение. get_roll принимает этот номер только для
+   брошенных костей.
+
+    \param[in] first указатель на первый индекс.
+    \param[in] last указатель на конец диапазона индексов.
+
+    \throw std::invalid_argument - если first > last.
+    \throw std::out_of_range - если какой-либо индекс выходит за границы вектора.
+*/
+void Dice::reroll(const size_t *first, const size_t *last)
+{
+    const size_t count = range_size(first, last);
+    const size_t size = get_size();
+    if (std::any_of(first, last, [size](const size_t index) { return index >= size; }))
         throw std::out_of_range("Index out of range");
-    return arr[index].to_change_value();
+    if (count == 0)
+        return;
+    if (counter_based)
+    {
+        ++epoch;
+        record_partial(first, last);
+    }
+    const OddsHandle *handle = handles.get_data();
+    RandomWord words[roll_block];
+    NumPoints faces[roll_block];
+    size_t begin = 0;
+    while (begin < count)
+    {
+        const OddsHandle run_handle = handle[first[begin]];
+        size_t end = begin + 1;
+        while (end < count && end - begin < roll_block && handle[first[end]] == run_handle)
+            ++end;
+        if (counter_based)
+        {
+            for (size_t i = begin; i < end; ++i)
+                words[i - begin] = engine.get_word(first[i], epoch);
+            words_to_faces<OneDice::faces>(run_handle, words, faces, end - begin);
+        }
+        else
+            random_odds<OneDice::faces>(run_handle, faces, end - begin);
+        for (size_t i = begin; i < end; ++i)
+            store_value(first[i], faces[i - begin]);
+        if (is_roll_journal_active())
+            for (size_t i = begin; i < end; ++i)
+                journal_roll(first[i], faces[i - begin], OneDice::faces);
+        begin = end;
+    }
+}
+
+/*!
+    \brief Бросок костей по условию
+    \details Бросает все кости, для которых predicate возвращает True, пакетно через reroll.
+
+    \param[in] predicate ссылка на условие броска кости.
+
+    \return Кол-во брошенных костей.
+*/
+size_t Dice::reroll_if(const std::function<bool(const OneDice &)> &predicate)
+{
+    Vector<size_t> indices;
+    const PackedNumPoints *value = values.get_data();
+    const OddsHandle *handle = handles.get_data();
+    for (size_t i = 0; i < get_size(); ++i)
+    {
+        OneDice dice(value[i]);
+        dice.set_odds_handle(handle[i]);
+        if (predicate(dice))
+            indices.push_back(i);
+    }
+    reroll(indices);
+    return indices.get_size();
 }
 
 /*!
@@ -186,13 +1073,18 @@ NumPoints Dice::operator()(const size_t index)
 */
 Dice &Dice::operator+=(const OneDice &other)
 {
-    arr.push_back(other);
+    values.push_back(static_cast<PackedNumPoints>(other.get_value()));
+    handles.push_back(other.get_odds_handle());
+    ++counts[other.get_value()];
+    total += other.get_value();
+    add_moments(other.get_odds_handle(), 1);
     return *this;
 }
 
 /*!
     \brief Оператор -=
-    \details Перегрузка оператора -=. Удаляет все кости с определённым значением value из текущего объекта
+    \details Перегрузка оператора -=. Удаляет все кости с определённым значением value из текущего объекта за один
+   проход.
 
     \param[in] value значение кости.
 
@@ -204,20 +1096,90 @@ Dice &Dice::operator-=(const NumPoints value)
 {
     if (!check_NumPoints(value))
         throw std::invalid_argument("Invalid argument value!");
-    for (Vector<OneDice>::iterator iter = arr.begin(); iter != arr.end(); ++iter)
+    remove_NumPoints(to_FaceMask(value));
+    return *this;
+}
+
+/*!
+    \brief Удаление костей по набору значений
+    \details Удаляет все кости, значения которых входят в набор mask, за один проход без ветвлений: каждая кость
+   записывается на место следующей оставшейся, а позиция записи сдвигается только для оставшихся костей. Порядок
+   оставшихся костей сохраняется.
+
+    \param[in] mask набор значений удаляемых костей.
+
+    \return Кол-во удалённых костей.
+
+    \throw std::invalid_argument - если в mask есть значение, которое не может являться значением кости.
+*/
+size_t Dice::remove_NumPoints(const FaceMask mask)
+{
+    if (mask >> OneDice::faces != 0)
+        throw std::invalid_argument("Invalid face mask!");
+    if (mask == 0)
+        return 0;
+    size_t keep[OneDice::faces + 1] = {};
+    for (size_t face = 1; face <= OneDice::faces; ++face)
+        keep[face] = (mask & to_FaceMask(face)) == 0;
+    PackedNumPoints *value_data = values.get_data();
+    OddsHandle *handle_data = handles.get_data();
+    const size_t size = get_size();
+    size_t kept = 0;
+    for (size_t i = 0; i < size; ++i)
     {
-        if ((*iter).get_value() == value)
+        PackedNumPoints value = value_data[i];
+        value_data[kept] = value;
+        handle_data[kept] = handle_data[i];
+        kept += keep[value];
+    }
+    values.erase(values.begin() + kept, values.end());
+    handles.erase(handles.begin() + kept, handles.end());
+    for (size_t face = 1; face <= OneDice::faces; ++face)
+        if (!keep[face])
         {
-            arr.erase(iter);
-            --iter;
+            total -= face * counts[face];
+            counts[face] = 0;
         }
+    count_moments();
+    return size - kept;
+}
+
+/*!
+    \brief Удаление костей по условию
+    \details Удаляет все кости, для которых predicate возвращает True, за один проход. Порядок оставшихся костей
+   сохраняется.
+
+    \param[in] predicate ссылка на условие удаления кости.
+
+    \return Кол-во удалённых костей.
+*/
+size_t Dice::remove_if(const std::function<bool(const OneDice &)> &predicate)
+{
+    PackedNumPoints *value_data = values.get_data();
+    OddsHandle *handle_data = handles.get_data();
+    const size_t size = get_size();
+    size_t kept = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        OneDice dice(value_data[i]);
+        dice.set_odds_handle(handle_data[i]);
+        if (predicate(dice))
+            continue;
+        value_data[kept] = value_data[i];
+        handle_data[kept] = handle_data[i];
+        ++kept;
     }
-    return *this;
+    values.erase(values.begin() + kept, values.end());
+    handles.erase(handles.begin() + kept, handles.end());
+    count_values();
+    count_moments();
+    return size - kept;
 }
 
 /*!
     \brief Оператор []
-    \details Перегрузка оператора []. Возвращет ссылку на кость с индексом index.
+    \details Перегрузка оператора []. Возвращет ссылку на кость с индексом index. Изменения через ссылку обновляют
+   кол-во костей с каждым значением и сумму.
 
     \param[in] index индекс кости.
 
@@ -225,16 +1187,38 @@ Dice &Dice::operator-=(const NumPoints value)
 
     \throw std::out_of_range - если index выходит за границы вектора.
 */
-OneDice &Dice::operator[](size_t index)
+OneDiceRef Dice::operator[](size_t index)
+{
+    if (index >= get_size())
+        throw std::out_of_range("Index out of range");
+    return OneDiceRef(this, index);
+}
+
+/*!
+    \brief Оператор []
+    \details Перегрузка оператора []. Возвращет копию кости с индексом index.
+
+    \param[in] index индекс кости.
+
+    \return Копию кости с индексом index.
+
+    \throw std::out_of_range - если index выходит за границы вектора.
+*/
+OneDice Dice::operator[](size_t index) const
 {
-    if (index >= arr.get_size())
+    if (index >= get_size())
         throw std::out_of_range("Index out of range");
-    return arr[index];
+    OneDice result(values[index]);
+    result.set_odds_handle(handles[index]);
+    return result;
 }
 
 /*!
     \brief Оператор ввода
-    \details Перегрузка оператора >>. Заполняет поля объекта dice значениями из потока ввода in.
+    \details Перегрузка оператора >>. Заполняет поля объекта dice значениями из потока ввода in. Значения читаются во
+   временную группу и записываются сразу в массивы без бросков. Память заранее выделяется не больше, чем под
+   input_reserve костей, поэтому неверное кол-во костей не приводит к выделению лишней памяти. При ошибке dice
+   остаётся пустой.
 
     \param[in] in ссылка потока ввода.
     \param[out] dice ссылка на объект Dice.
@@ -248,18 +1232,31 @@ std::istream &operator>>(std::istream &in, Dice &dice)
     dice = Dice();
     size_t count;
     in >> count;
+    if (in.fail())
+    {
+        in.clear();
+        in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        throw std::invalid_argument("Invalid input value!");
+    }
+    Dice result;
+    result.values.resize(std::min(count, input_reserve));
+    result.handles.resize(std::min(count, input_reserve));
     for (size_t i = 0; i < count; ++i)
     {
         NumPoints value;
         in >> value;
-        if (in.fail())
+        if (in.fail() || !check_NumPoints(value))
         {
             in.clear();
             in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             throw std::invalid_argument("Invalid input value!");
         }
-        dice.arr.push_back(OneDice(value));
+        result.values.push_back(static_cast<PackedNumPoints>(value));
+        result.handles.push_back(fair_odds_handle);
     }
+    result.count_values();
+    result.add_moments(fair_odds_handle, static_cast<double>(count));
+    dice = std::move(result);
     return in;
 }
 
@@ -275,12 +1272,11 @@ std::istream &operator>>(std::istream &in, Dice &dice)
 std::ostream &operator<<(std::ostream &out, const Dice &dice) noexcept
 {
     out << "{";
-    std::for_each(dice.arr.cbegin(), dice.arr.cend() - 1,
-                  [&out](const OneDice &item) { out << item.get_value() << ", "; });
-    if (!dice.arr.is_empty())
-        out << (*(dice.arr.cend() - 1)).get_value();
+    const PackedNumPoints *value = dice.get_values();
+    for (size_t i = 0; i < dice.get_size(); ++i)
+        out << (i > 0 ? ", " : "") << static_cast<NumPoints>(value[i]);
     out << "}";
     return out;
 }
 
-/*! @} */
\ No newline at end of file
+/*! @} */
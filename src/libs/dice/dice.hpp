@@ -11,16 +11,104 @@
     @{
 */
 
+#include "./moments/moments.hpp"
 #include "./oneDice/oneDice.hpp"
+#include "./random/philox/philox.hpp"
+#include "./reduce/reduce.hpp"
+#include "./sampling/sampling.hpp"
+
+#include <functional>
+
+typedef unsigned FaceMask; ///< Набор значений костей, значению face соответствует бит face - 1
+
+/*!
+    \brief Маска значения
+    \details Возвращает набор значений, состоящий из одного значения face.
+
+    \param[in] face значение кости.
+
+    \return Набор значений с единственным значением face.
+*/
+constexpr FaceMask to_FaceMask(const NumPoints face) noexcept
+{
+    return FaceMask(1) << (face - 1);
+}
+
+class Dice;
+
+/*!
+    \brief Ссылка на кость в группе
+    \details Объект OneDiceRef ссылается на кость с индексом index в объекте Dice. Значения и шансы костей хранятся в
+   группе раздельно, поэтому вместо ссылки на OneDice оператор [] возвращает OneDiceRef, который читает и меняет
+   кость на месте.
+*/
+class OneDiceRef
+{
+    private:
+        Dice *dice;
+        size_t index;
+
+        OneDiceRef(Dice *dice, const size_t index) noexcept;
+
+        friend class Dice;
+
+    public:
+        OneDiceRef(const OneDiceRef &other) noexcept = default;
+
+        void set_odds(const Odds &input_odds);
+        void set_odds_handle(const OddsHandle handle);
+        void set_value(const NumPoints value);
+
+        NumPoints get_value() const noexcept;
+        AsciiArt get_value_AsciiArt() const;
+        Odds get_odds() const;
+        OddsHandle get_odds_handle() const noexcept;
+
+        NumPoints to_change_value();
+
+        operator OneDice() const;
+        bool operator==(const OneDice &other) const;
+
+        OneDiceRef &operator=(const OneDice &other);
+        OneDiceRef &operator=(const OneDiceRef &other);
+};
 
 /*!
     \brief Класс для работы с группой костей
-    \details Объект Dice хранит vector объектов класса OneDice.
+    \details Объект Dice хранит значения костей в плотном массиве PackedNumPoints, а номера шансов выпадения в
+   отдельном массиве той же длины. Кол-во костей с каждым значением и сумма значений обновляются при каждом изменении
+   костей, поэтому поиск значения и сумма вычисляются за O(1). По умолчанию кости
+   бросаются генератором потока. Если задан генератор на счётчике, значение каждой кости в каждом броске определяется
+   зерном, номером группы, индексом кости и номером броска (эпохой), поэтому любой прошлый бросок можно вычислить
+   заново. Для бросков части костей запоминается, какие кости в них бросались.
 */
 class Dice
 {
     private:
-        Vector<OneDice> arr;
+        Vector<PackedNumPoints> values;
+        Vector<OddsHandle> handles;
+        CounterEngine engine;
+        bool counter_based = false;
+        std::uint32_t epoch = 0;
+        Vector<std::uint32_t> partial_epochs;
+        Vector<size_t> partial_starts;
+        Vector<size_t> partial_indices;
+        size_t counts[OneDice::faces + 1] = {};
+        std::uint64_t total = 0;
+        OddsMoments moments;
+
+        void count_values() noexcept;
+        void count_moments();
+        void add_moments(const OddsHandle handle, const double count);
+        void store_value(const size_t index, const NumPoints value) noexcept;
+        void store_handle(const size_t index, const OddsHandle handle);
+        void roll_range(const size_t first, const size_t count, const OddsHandle handle, NumPoints *faces) const;
+        void roll_chunk(const CounterEngine &chunk_engine, const std::uint32_t chunk_epoch, const size_t first,
+                        const size_t last, size_t *chunk_counts);
+        void record_partial(const size_t *first, const size_t *last);
+        bool was_rolled(const size_t index, const std::uint32_t roll_epoch) const;
+
+        friend class OneDiceRef;
 
     public:
         Dice() noexcept;
@@ -29,22 +117,52 @@ class Dice
 
         Dice(const size_t size);
         Dice(const Vector<NumPoints> &input_vector);
+        Dice(const NumPoints *first, const NumPoints *last);
+        Dice(const PackedNumPoints *first, const PackedNumPoints *last);
 
         size_t get_size() const noexcept;
         AsciiArt get_AsciiArt() const noexcept;
+        const PackedNumPoints *get_values() const noexcept;
+        const OddsHandle *get_odds_handles() const noexcept;
+
+        void set_values(const PackedNumPoints *first, const PackedNumPoints *last);
+        void load_values(Vector<PackedNumPoints> &&input_values);
 
         bool has_NumPoints(const NumPoints value) const;
+        size_t count_NumPoints(const NumPoints value) const;
+
+        std::uint64_t sum() const noexcept;
 
-        NumPoints sum() const noexcept;
+        OddsMoments get_moments() const noexcept;
+        double mean() const noexcept;
+        double variance() const noexcept;
+        double quantile(const double p, const QuantileMethod method = QuantileMethod::edgeworth) const;
+
+        void set_CounterEngine(const CounterEngine &counter_engine, const std::uint32_t start_epoch = 0);
+        void reset_CounterEngine() noexcept;
+        bool is_counter_based() const noexcept;
+        CounterEngine get_CounterEngine() const noexcept;
+        std::uint32_t get_epoch() const noexcept;
+
+        NumPoints get_roll(const size_t index, const std::uint32_t roll_epoch) const;
+        NumPoints replay(const size_t index, const std::uint32_t roll_epoch);
 
         Dice &operator=(const Dice &other);
         Dice &operator=(Dice &&other);
 
-        void operator()() noexcept;
+        void operator()();
+        void roll_parallel(size_t threads = 0);
+        void reroll(const Vector<size_t> &indices);
+        void reroll(const size_t *first, const size_t *last);
+        size_t reroll_if(const std::function<bool(const OneDice &)> &predicate);
         NumPoints operator()(const size_t index);
         Dice &operator+=(const OneDice &other);
         Dice &operator-=(const NumPoints value);
-        OneDice &operator[](size_t index);
+
+        size_t remove_NumPoints(const FaceMask mask);
+        size_t remove_if(const std::function<bool(const OneDice &)> &predicate);
+        OneDiceRef operator[](size_t index);
+        OneDice operator[](size_t index) const;
 
         friend std::istream &operator>>(std::istream &in, Dice &dice);
         friend std::ostream &operator<<(std::ostream &out, const Dice &dice) noexcept;
@@ -0,0 +1,277 @@
+#include "distribution.hpp"
+
+/*!
+    \addtogroup Distribution_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <vector>
+
+/*!
+    \brief Быстрое преобразование Фурье
+    \details Выполняет на месте итеративное преобразование Фурье по основанию 2. Длина массива должна быть степенью 2.
+   Корни из единицы вычисляются заранее, чтобы погрешность не накапливалась по длине массива.
+
+    \param[in,out] values ссылка на массив комплексных чисел.
+    \param[in] inverse True для обратного преобразования, результат которого делится на длину массива.
+*/
+void fft(std::vector<std::complex<double>> &values, const bool inverse)
+{
+    const size_t n = values.size();
+    for (size_t i = 1, j = 0; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(values[i], values[j]);
+    }
+    const double angle = 2 * std::acos(-1.0) / static_cast<double>(n) * (inverse ? 1 : -1);
+    std::vector<std::complex<double>> roots(n / 2);
+    for (size_t k = 0; k < n / 2; ++k)
+        roots[k] = std::polar(1.0, angle * static_cast<double>(k));
+    for (size_t length = 2; length <= n; length <<= 1)
+    {
+        const size_t stride = n / length;
+        for (size_t first = 0; first < n; first += length)
+            for (size_t k = 0; k < length / 2; ++k)
+            {
+                std::complex<double> even = values[first + k];
+                std::complex<double> odd = values[first + k + length / 2] * roots[k * stride];
+                values[first + k] = even + odd;
+                values[first + k + length / 2] = even - odd;
+            }
+    }
+    if (inverse)
+        for (std::complex<double> &value : values)
+            value /= static_cast<double>(n);
+}
+
+/*!
+    \brief Свёртка распределений
+    \details Вычисляет распределение суммы двух независимых величин с распределениями a и b. Если меньшее из
+   распределений короче fft_threshold, свёртка вычисляется напрямую, иначе через быстрое преобразование Фурье. Свёртка
+   распределения с самим собой требует одного прямого преобразования вместо двух. Отрицательные погрешности
+   преобразования обнуляются.
+
+    \param[in] a ссылка на первое распределение.
+    \param[in] b ссылка на второе распределение.
+
+    \return Распределение суммы длины a.get_size() + b.get_size() - 1.
+*/
+Vector<double> convolve(const Vector<double> &a, const Vector<double> &b)
+{
+    const size_t a_size = a.get_size(), b_size = b.get_size();
+    if (a_size == 0 || b_size == 0)
+        return Vector<double>(0, 0.0);
+    const size_t length = a_size + b_size - 1;
+    Vector<double> result(length, 0.0);
+    const double *a_data = a.get_data(), *b_data = b.get_data();
+    double *out = result.get_data();
+    if (std::min(a_size, b_size) < fft_threshold)
+    {
+        for (size_t i = 0; i < a_size; ++i)
+            for (size_t j = 0; j < b_size; ++j)
+                out[i + j] += a_data[i] * b_data[j];
+        return result;
+    }
+    size_t n = 1;
+    while (n < length)
+        n <<= 1;
+    std::vector<std::complex<double>> fa(a_data, a_data + a_size);
+    fa.resize(n);
+    fft(fa, false);
+    if (&a == &b)
+        for (std::complex<double> &value : fa)
+            value *= value;
+    else
+    {
+        std::vector<std::complex<double>> fb(b_data, b_data + b_size);
+        fb.resize(n);
+        fft(fb, false);
+        for (size_t i = 0; i < n; ++i)
+            fa[i] *= fb[i];
+    }
+    fft(fa, true);
+    for (size_t i = 0; i < length; ++i)
+        out[i] = std::max(fa[i].real(), 0.0);
+    return result;
+}
+
+/*!
+    \brief Стандартный конструктор
+    \details Создаёт распределение суммы пустой группы: сумма равна 0 с вероятностью 1.
+*/
+SumDistribution::SumDistribution() : pmf(1, 1.0)
+{
+    update_cdf();
+}
+
+/*!
+    \brief Конструктор с группой костей
+    \details Создаёт распределение суммы значений костей группы dice. Кости группируются по шансам выпадения, для
+   каждой группы распределение возводится в степень, затем распределения групп сворачиваются.
+
+    \param[in] dice ссылка на группу костей.
+*/
+SumDistribution::SumDistribution(const Dice &dice) : SumDistribution()
+{
+    std::map<OddsHandle, std::uint64_t> groups;
+    const OddsHandle *handles = dice.get_odds_handles();
+    for (size_t i = 0; i < dice.get_size(); ++i)
+        ++groups[handles[i]];
+    for (const std::pair<const OddsHandle, std::uint64_t> &group : groups)
+        *this *= SumDistribution(OddsRegistry<OneDice::faces>::get_odds(group.first), group.second);
+}
+
+/*!
+    \brief Конструктор с одинаковыми костями
+    \details Создаёт распределение суммы значений count костей с шансами выпадения odds возведением распределения
+   одной кости в степень count возведением в квадрат.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] odds ссылка на шансы выпадения граней.
+    \param[in] count кол-во костей.
+
+    \throw std::invalid_argument - если сумма шансов равна 0.
+*/
+template <size_t Faces>
+SumDistribution::SumDistribution(const BasicOdds<Faces> &odds, const std::uint64_t count) : SumDistribution()
+{
+    double total = 0;
+    for (size_t i = 0; i < Faces; ++i)
+        total += odds.get_odds(i);
+    if (total == 0)
+        throw std::invalid_argument("Invalid odds!");
+    size_t first = 0, last = Faces;
+    while (odds.get_odds(first) == 0)
+        ++first;
+    while (odds.get_odds(last - 1) == 0)
+        --last;
+    Vector<double> base(last - first, 0.0);
+    for (size_t i = first; i < last; ++i)
+        base[i - first] = odds.get_odds(i) / total;
+
+    Vector<double> result(1, 1.0);
+    for (std::uint64_t power = count; power > 0; power >>= 1)
+    {
+        if (power & 1)
+            result = convolve(result, base);
+        if (power > 1)
+            base = convolve(base, base);
+    }
+    pmf = std::move(result);
+    min_sum = count * (first + 1);
+    update_cdf();
+}
+
+/*!
+    \brief Пересчёт накопленных вероятностей
+    \details Нормирует распределение, чтобы сумма вероятностей была равна 1, и вычисляет накопленные вероятности.
+*/
+void SumDistribution::update_cdf()
+{
+    const size_t size = pmf.get_size();
+    double *probabilities = pmf.get_data();
+    double total = 0;
+    for (size_t i = 0; i < size; ++i)
+        total += probabilities[i];
+    cdf = Vector<double>(size, 0.0);
+    double *cumulative = cdf.get_data();
+    double running = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        probabilities[i] /= total;
+        running += probabilities[i];
+        cumulative[i] = std::min(running, 1.0);
+    }
+    if (size > 0)
+        cumulative[size - 1] = 1;
+}
+
+/*!
+    \brief Геттер минимальной суммы
+    \details Возвращает наименьшее значение суммы с ненулевой вероятностью.
+
+    \return Минимальную сумму.
+*/
+std::uint64_t SumDistribution::get_min() const noexcept
+{
+    return min_sum;
+}
+
+/*!
+    \brief Геттер максимальной суммы
+    \details Возвращает наибольшее значение суммы с ненулевой вероятностью.
+
+    \return Максимальную сумму.
+*/
+std::uint64_t SumDistribution::get_max() const noexcept
+{
+    return min_sum + pmf.get_size() - 1;
+}
+
+/*!
+    \brief Вероятность суммы
+    \details Возвращает вероятность того, что сумма равна sum.
+
+    \param[in] sum значение суммы.
+
+    \return P(сумма = sum).
+*/
+double SumDistribution::get_pmf(const std::uint64_t sum) const noexcept
+{
+    if (sum < min_sum || sum > get_max())
+        return 0;
+    return pmf.get_data()[sum - min_sum];
+}
+
+/*!
+    \brief Накопленная вероятность суммы
+    \details Возвращает вероятность того, что сумма не больше sum.
+
+    \param[in] sum значение суммы.
+
+    \return P(сумма <= sum).
+*/
+double SumDistribution::get_cdf(const std::uint64_t sum) const noexcept
+{
+    if (sum < min_sum)
+        return 0;
+    if (sum >= get_max())
+        return 1;
+    return cdf.get_data()[sum - min_sum];
+}
+
+/*!
+    \brief Оператор *=
+    \details Перегрузка оператора *=. Заменяет распределение распределением суммы текущей величины и независимой
+   величины с распределением other.
+
+    \param[in] other ссылка на другое распределение.
+
+    \return Ссылку на текущий объект.
+*/
+SumDistribution &SumDistribution::operator*=(const SumDistribution &other)
+{
+    pmf = convolve(pmf, other.pmf);
+    min_sum += other.min_sum;
+    update_cdf();
+    return *this;
+}
+
+template SumDistribution::SumDistribution(const BasicOdds<4> &odds, const std::uint64_t count);
+template SumDistribution::SumDistribution(const BasicOdds<6> &odds, const std::uint64_t count);
+template SumDistribution::SumDistribution(const BasicOdds<8> &odds, const std::uint64_t count);
+template SumDistribution::SumDistribution(const BasicOdds<10> &odds, const std::uint64_t count);
+template SumDistribution::SumDistribution(const BasicOdds<12> &odds, const std::uint64_t count);
+template SumDistribution::SumDistribution(const BasicOdds<20> &odds, const std::uint64_t count);
+template SumDistribution::SumDistribution(const BasicOdds<100> &odds, const std::uint64_t count);
+
+/*! @} */
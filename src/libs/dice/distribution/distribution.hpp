@@ -0,0 +1,53 @@
+/*!
+    \defgroup Distribution_submodule Распределение суммы
+    \ingroup Dice_module
+    \brief Точное распределение суммы значений группы костей
+*/
+#ifndef DISTRIBUTION_HPP
+#define DISTRIBUTION_HPP
+
+/*!
+    \addtogroup Distribution_submodule
+    @{
+*/
+
+#include "../dice.hpp"
+
+constexpr size_t fft_threshold = 64; ///< Мин. длина меньшего распределения, с которой свёртка выполняется через БПФ
+
+/*!
+    \brief Класс распределения суммы
+    \details Объект SumDistribution хранит вероятность каждого значения суммы независимых костей и накопленные
+    вероятности. Распределение группы вычисляется свёрткой распределений костей: кости с одинаковыми шансами
+    объединяются, и свёртка одинаковых распределений возводится в степень возведением в квадрат. Длинные распределения
+    сворачиваются через быстрое преобразование Фурье, поэтому вероятности меньше ~1e-15 вычисляются с абсолютной,
+    а не относительной точностью.
+*/
+class SumDistribution
+{
+    private:
+        Vector<double> pmf;
+        Vector<double> cdf;
+        std::uint64_t min_sum = 0;
+
+        void update_cdf();
+
+    public:
+        SumDistribution();
+        SumDistribution(const Dice &dice);
+        template <size_t Faces> SumDistribution(const BasicOdds<Faces> &odds, const std::uint64_t count);
+
+        std::uint64_t get_min() const noexcept;
+        std::uint64_t get_max() const noexcept;
+
+        double get_pmf(const std::uint64_t sum) const noexcept;
+        double get_cdf(const std::uint64_t sum) const noexcept;
+
+        SumDistribution &operator*=(const SumDistribution &other);
+};
+
+Vector<double> convolve(const Vector<double> &a, const Vector<double> &b);
+
+/*! @} */
+
+#endif // DISTRIBUTION_HPP
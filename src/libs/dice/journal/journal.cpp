@@ -0,0 +1,377 @@
+#include "journal.hpp"
+
+/*!
+    \addtogroup Journal_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/*!
+    \brief Буфер потока
+    \details События одного потока до передачи записи. Мьютекс захватывает только сам поток и остановка журнала,
+   поэтому он почти всегда свободен.
+*/
+struct ThreadBuffer
+{
+        std::mutex mutex;
+        std::vector<RollEvent> events;
+        std::uint32_t thread = 0;
+        std::uint64_t session = 0;
+};
+
+/*!
+    \brief Состояние журнала
+    \details Очередь заполненных буферов, запас пустых буферов, буферы всех потоков и поток записи. Мьютекс control
+   упорядочивает включение и выключение журнала. Мьютекс буфера потока захватывается раньше мьютекса mutex, и никогда
+   наоборот.
+*/
+struct JournalState
+{
+        std::mutex control;
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::vector<std::vector<RollEvent>> queue;
+        std::vector<std::vector<RollEvent>> free_buffers;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        std::ofstream output;
+        std::thread writer;
+        std::string path;
+        bool stopping = false;
+        bool failed = false;
+        std::uint32_t next_thread = 0;
+        std::atomic<std::uint64_t> session{0};
+        std::atomic<std::uint64_t> recorded{0};
+        std::atomic<std::uint64_t> written{0};
+        std::atomic<std::uint64_t> batches{0};
+};
+
+static std::atomic<bool> journal_active(false);          ///< Признак включённого журнала
+static JournalState journal_state;                      ///< Состояние журнала
+static thread_local std::shared_ptr<ThreadBuffer> thread_buffer; ///< Буфер текущего потока
+
+/*!
+    \brief Поток записи
+    \details Ждёт заполненные буферы, забирает всю очередь сразу и записывает её в файл без захвата мьютекса.
+   Записанные буферы возвращаются в запас. Завершается, когда журнал остановлен и очередь пуста.
+*/
+static void journal_writer()
+{
+    JournalState &state = journal_state;
+    std::vector<std::vector<RollEvent>> batch;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (true)
+    {
+        state.ready.wait(lock, [&state]() { return !state.queue.empty() || state.stopping; });
+        if (state.queue.empty())
+            break;
+        batch.swap(state.queue);
+        lock.unlock();
+        for (const std::vector<RollEvent> &events : batch)
+        {
+            state.output.write(reinterpret_cast<const char *>(events.data()),
+                               static_cast<std::streamsize>(events.size() * sizeof(RollEvent)));
+            state.written += events.size();
+        }
+        ++state.batches;
+        lock.lock();
+        state.failed = state.failed || !state.output;
+        for (std::vector<RollEvent> &events : batch)
+        {
+            events.clear();
+            state.free_buffers.push_back(std::move(events));
+        }
+        batch.clear();
+    }
+}
+
+/*!
+    \brief Включение журнала
+    \details Создаёт файл журнала path, записывает заголовок и запускает поток записи. С этого момента все броски
+   OneDice::to_change_value и бросков Dice попадают в журнал.
+
+    \param[in] path ссылка на путь к файлу журнала.
+
+    \throw std::logic_error - если журнал уже включён.
+    \throw std::system_error - если файл не удалось создать.
+*/
+void start_roll_journal(const std::string &path)
+{
+    JournalState &state = journal_state;
+    std::lock_guard<std::mutex> control(state.control);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (journal_active.load())
+        throw std::logic_error("Roll journal is already active!");
+    state.output.open(path, std::ios::binary | std::ios::trunc);
+    if (!state.output)
+    {
+        state.output.clear();
+        throw std::system_error(std::make_error_code(std::errc::io_error), path);
+    }
+    RollJournalHeader header = {};
+    std::memcpy(header.magic, journal_magic, sizeof(header.magic));
+    header.version = journal_version;
+    header.event_size = sizeof(RollEvent);
+    state.output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    state.path = path;
+    state.buffers.clear();
+    state.stopping = false;
+    state.failed = false;
+    state.next_thread = 0;
+    ++state.session;
+    state.recorded = 0;
+    state.written = 0;
+    state.batches = 0;
+    state.writer = std::thread(journal_writer);
+    journal_active = true;
+}
+
+/*!
+    \brief Выключение журнала
+    \details Забирает неполные буферы всех потоков, дожидается записи всех событий и закрывает файл. Броски,
+   сделанные одновременно с выключением, могут не попасть в журнал. Если журнал выключен, ничего не делает.
+
+    \throw std::system_error - если события не удалось записать в файл.
+*/
+void stop_roll_journal()
+{
+    JournalState &state = journal_state;
+    std::lock_guard<std::mutex> control(state.control);
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!journal_active.exchange(false))
+            return;
+        buffers.swap(state.buffers);
+    }
+    std::vector<std::vector<RollEvent>> rest;
+    for (const std::shared_ptr<ThreadBuffer> &buffer : buffers)
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        if (!buffer->events.empty())
+            rest.push_back(std::move(buffer->events));
+        buffer->events.clear();
+    }
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (std::vector<RollEvent> &events : rest)
+            state.queue.push_back(std::move(events));
+        state.stopping = true;
+    }
+    state.ready.notify_one();
+    state.writer.join();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.free_buffers.clear();
+    state.output.close();
+    bool failed = state.failed || !state.output;
+    state.output.clear();
+    if (failed)
+        throw std::system_error(std::make_error_code(std::errc::io_error), state.path);
+}
+
+/*!
+    \brief Проверка журнала
+    \return True если журнал включён. Иначе False.
+*/
+bool is_roll_journal_active() noexcept
+{
+    return journal_active.load(std::memory_order_relaxed);
+}
+
+/*!
+    \brief Геттер счётчиков журнала
+    \return Счётчики текущего или последнего журнала.
+*/
+RollJournalStats get_roll_journal_stats() noexcept
+{
+    RollJournalStats stats;
+    stats.recorded = journal_state.recorded.load();
+    stats.written = journal_state.written.load();
+    stats.batches = journal_state.batches.load();
+    return stats;
+}
+
+/*!
+    \brief Буфер текущего потока
+    \details Возвращает буфер текущего потока, регистрируя новый при первом броске в этом журнале.
+
+    \return Ссылка на буфер потока.
+*/
+static ThreadBuffer &get_thread_buffer()
+{
+    JournalState &state = journal_state;
+    if (!thread_buffer || thread_buffer->session != state.session)
+    {
+        std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        buffer->session = state.session;
+        buffer->thread = state.next_thread++;
+        buffer->events.reserve(journal_buffer_events);
+        state.buffers.push_back(buffer);
+        thread_buffer = buffer;
+    }
+    return *thread_buffer;
+}
+
+/*!
+    \brief Передача буфера записи
+    \details Ставит заполненный буфер потока в очередь записи и заменяет его пустым из запаса. Мьютекс буфера
+   должен быть захвачен.
+
+    \param[in] buffer ссылка на буфер потока.
+*/
+static void hand_off(ThreadBuffer &buffer)
+{
+    JournalState &state = journal_state;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!journal_active.load() || buffer.session != state.session)
+            return;
+        state.queue.push_back(std::move(buffer.events));
+        if (state.free_buffers.empty())
+            buffer.events = std::vector<RollEvent>();
+        else
+        {
+            buffer.events = std::move(state.free_buffers.back());
+            state.free_buffers.pop_back();
+        }
+    }
+    buffer.events.reserve(journal_buffer_events);
+    state.ready.notify_one();
+}
+
+/*!
+    \brief Время броска
+    \return Кол-во наносекунд от эпохи системных часов.
+*/
+static std::uint64_t journal_time() noexcept
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::system_clock::now().time_since_epoch())
+                                          .count());
+}
+
+/*!
+    \brief Запись броска
+    \details Добавляет событие в буфер текущего потока. Если журнал выключен, ничего не делает.
+
+    \param[in] index номер кости в группе или journal_no_index.
+    \param[in] value выпавшее значение.
+    \param[in] faces кол-во граней кости.
+*/
+void journal_roll(const std::uint64_t index, const NumPoints value, const NumPoints faces)
+{
+    if (!is_roll_journal_active())
+        return;
+    ThreadBuffer &buffer = get_thread_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back(RollEvent{journal_time(), index, buffer.thread, value, faces});
+    ++journal_state.recorded;
+    if (buffer.events.size() >= journal_buffer_events)
+        hand_off(buffer);
+}
+
+/*!
+    \brief Запись броска группы
+    \details Добавляет в буфер текущего потока события для count костей с номерами first_index.. и значениями
+   values. Все события получают одно время. Если журнал выключен, ничего не делает.
+
+    \param[in] first_index номер первой кости.
+    \param[in] values указатель на значения костей.
+    \param[in] count кол-во костей.
+    \param[in] faces кол-во граней костей.
+*/
+void journal_rolls(const std::uint64_t first_index, const PackedNumPoints *values, const size_t count,
+                   const NumPoints faces)
+{
+    if (!is_roll_journal_active() || count == 0)
+        return;
+    ThreadBuffer &buffer = get_thread_buffer();
+    std::uint64_t timestamp = journal_time();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    size_t done = 0;
+    while (done < count)
+    {
+        size_t used = buffer.events.size();
+        size_t block = std::min(count - done, std::max(journal_buffer_events, used + 1) - used);
+        buffer.events.resize(used + block);
+        RollEvent *event = buffer.events.data() + used;
+        for (size_t i = 0; i < block; ++i)
+            event[i] = RollEvent{timestamp, first_index + done + i, buffer.thread, values[done + i], faces};
+        done += block;
+        if (buffer.events.size() >= journal_buffer_events)
+            hand_off(buffer);
+    }
+    journal_state.recorded += count;
+}
+
+/*!
+    \brief Конструктор с путём к файлу
+    \details Отображает журнал path в память и проверяет заголовок.
+
+    \param[in] path ссылка на путь к файлу журнала.
+
+    \throw std::system_error - если файл не удалось открыть или отобразить.
+    \throw std::invalid_argument - если файл не является журналом этой версии.
+*/
+RollJournalReader::RollJournalReader(const std::string &path) : file(path)
+{
+    if (file.get_size() < sizeof(RollJournalHeader))
+        throw std::invalid_argument("Invalid roll journal!");
+    const RollJournalHeader *header = reinterpret_cast<const RollJournalHeader *>(file.get_data());
+    if (std::memcmp(header->magic, journal_magic, sizeof(header->magic)) != 0 ||
+        header->event_size != sizeof(RollEvent))
+        throw std::invalid_argument("Invalid roll journal!");
+    if (header->version != journal_version)
+        throw std::invalid_argument("Unsupported roll journal version!");
+    events = reinterpret_cast<const RollEvent *>(file.get_data() + sizeof(RollJournalHeader));
+    size = (file.get_size() - sizeof(RollJournalHeader)) / sizeof(RollEvent);
+}
+
+/*!
+    \brief Геттер кол-ва событий
+    \details Неполное последнее событие, например после аварийного завершения, не учитывается.
+
+    \return Кол-во событий в журнале.
+*/
+size_t RollJournalReader::get_size() const noexcept
+{
+    return size;
+}
+
+/*!
+    \brief Геттер массива событий
+    \return Указатель на первое событие в отображении файла.
+*/
+const RollEvent *RollJournalReader::get_events() const noexcept
+{
+    return events;
+}
+
+/*!
+    \brief Перегрузка оператора []
+    \param[in] index номер события.
+
+    \return Ссылка на событие.
+
+    \throw std::out_of_range - если номер события больше или равен кол-ву событий.
+*/
+const RollEvent &RollJournalReader::operator[](const size_t index) const
+{
+    if (index >= size)
+        throw std::out_of_range("Index out of range!");
+    return events[index];
+}
+
+/*! @} */
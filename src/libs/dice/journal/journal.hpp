@@ -0,0 +1,93 @@
+/*!
+    \defgroup Journal_submodule Журнал бросков
+    \ingroup Dice_module
+    \brief Асинхронная запись всех бросков в двоичный журнал
+*/
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+/*!
+    \addtogroup Journal_submodule
+    @{
+*/
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "../mapped/mapped.hpp"
+#include "../oneDice/odds/odds.hpp"
+
+constexpr char journal_magic[8] = {'D', 'I', 'C', 'E', 'L', 'O', 'G', '\0'}; ///< Сигнатура журнала
+constexpr std::uint32_t journal_version = 1;                                 ///< Версия формата журнала
+constexpr size_t journal_buffer_events = 4096;  ///< Кол-во событий в буфере потока, передаваемом записи
+constexpr std::uint64_t journal_no_index = std::numeric_limits<std::uint64_t>::max(); ///< Номер отдельной кости
+
+/*!
+    \brief Событие броска
+    \details Одна запись журнала. Время задаётся в наносекундах от эпохи системных часов. Номер кости равен
+   journal_no_index для кости вне группы.
+*/
+struct RollEvent
+{
+        std::uint64_t timestamp; ///< Время броска
+        std::uint64_t index;     ///< Номер кости в группе
+        std::uint32_t thread;    ///< Номер потока в журнале
+        std::uint16_t value;     ///< Выпавшее значение
+        std::uint16_t faces;     ///< Кол-во граней кости
+};
+
+/*!
+    \brief Заголовок журнала
+    \details За заголовком следуют события RollEvent. События одного потока идут в порядке бросков, события разных
+   потоков перемешаны пачками.
+*/
+struct RollJournalHeader
+{
+        char magic[8];            ///< Сигнатура journal_magic
+        std::uint32_t version;    ///< Версия формата
+        std::uint32_t event_size; ///< Размер события в байтах
+};
+
+/*!
+    \brief Счётчики журнала
+*/
+struct RollJournalStats
+{
+        std::uint64_t recorded = 0; ///< Кол-во событий, принятых от потоков
+        std::uint64_t written = 0;  ///< Кол-во событий, записанных в файл
+        std::uint64_t batches = 0;  ///< Кол-во пачек записи
+};
+
+void start_roll_journal(const std::string &path);
+void stop_roll_journal();
+bool is_roll_journal_active() noexcept;
+RollJournalStats get_roll_journal_stats() noexcept;
+
+void journal_roll(const std::uint64_t index, const NumPoints value, const NumPoints faces);
+void journal_rolls(const std::uint64_t first_index, const PackedNumPoints *values, const size_t count,
+                   const NumPoints faces);
+
+/*!
+    \brief Класс чтения журнала
+    \details Объект RollJournalReader отображает журнал в память и даёт доступ к событиям без копирования.
+*/
+class RollJournalReader
+{
+    private:
+        MappedFile file;
+        const RollEvent *events = nullptr;
+        size_t size = 0;
+
+    public:
+        RollJournalReader(const std::string &path);
+
+        size_t get_size() const noexcept;
+        const RollEvent *get_events() const noexcept;
+
+        const RollEvent &operator[](const size_t index) const;
+};
+
+/*! @} */
+
+#endif // JOURNAL_HPP
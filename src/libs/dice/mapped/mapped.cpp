@@ -0,0 +1,163 @@
+#include "mapped.hpp"
+
+/*!
+    \addtogroup Mapped_submodule
+    @{
+*/
+
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_POSIX
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+/*!
+    \brief Стандартный конструктор
+    \details Создаёт пустой объект без файла.
+*/
+MappedFile::MappedFile() noexcept
+{
+}
+
+/*!
+    \brief Конструктор с путём к файлу
+    \details Отображает файл path в память только для чтения. По умолчанию страницы загружаются по мере обращения,
+   поэтому открытие большого файла не читает его целиком. Если задан prefault, то где возможно страницы загружаются
+   сразу при отображении, чтобы последовательное чтение всего файла не прерывалось на ошибках страниц. Пустой файл не
+   отображается.
+
+    \param[in] path ссылка на путь к файлу.
+    \param[in] prefault признак загрузки всех страниц при отображении.
+
+    \throw std::system_error - если файл не удалось открыть или отобразить.
+*/
+MappedFile::MappedFile(const std::string &path, const bool prefault)
+{
+#if defined(MAPPED_POSIX)
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        throw std::system_error(errno, std::generic_category(), path);
+    struct stat info;
+    if (fstat(file, &info) != 0)
+    {
+        int error = errno;
+        close(file);
+        throw std::system_error(error, std::generic_category(), path);
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size > 0)
+    {
+        int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+        if (prefault)
+            flags |= MAP_POPULATE;
+#endif
+        void *mapping = mmap(nullptr, size, PROT_READ, flags, file, 0);
+        if (mapping == MAP_FAILED)
+        {
+            int error = errno;
+            close(file);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(mapping);
+    }
+    close(file);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), path);
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+#endif
+}
+
+/*!
+    \brief Конструктор перемещения
+    \details Переносит отображение из other в текущий объект.
+
+    \param[in] other перемещающая ссылка на другой объект MappedFile.
+*/
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+/*!
+    \brief Деструктор
+    \details Освобождает отображение файла.
+*/
+MappedFile::~MappedFile() noexcept
+{
+    unmap();
+}
+
+/*!
+    \brief Освобождение отображения
+    \details Освобождает отображение файла и обнуляет поля.
+*/
+void MappedFile::unmap() noexcept
+{
+#if defined(MAPPED_POSIX)
+    if (data != nullptr)
+        munmap(const_cast<char *>(data), size);
+#endif
+    buffer.clear();
+    data = nullptr;
+    size = 0;
+}
+
+/*!
+    \brief Геттер данных
+    \details Возвращает указатель на содержимое файла.
+
+    \return Указатель на содержимое файла или nullptr для пустого файла.
+*/
+const char *MappedFile::get_data() const noexcept
+{
+    return data;
+}
+
+/*!
+    \brief Геттер размера
+    \details Возвращает размер файла в байтах.
+
+    \return Размер файла.
+*/
+size_t MappedFile::get_size() const noexcept
+{
+    return size;
+}
+
+/*!
+    \brief Оператор перемещения
+    \details Освобождает текущее отображение и переносит отображение из other в текущий объект.
+
+    \param[in] other перемещающая ссылка на другой объект MappedFile.
+
+    \return Ссылку на текущий объект.
+*/
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+    unmap();
+    buffer = std::move(other.buffer);
+    size = other.size;
+    data = buffer.empty() ? other.data : buffer.data();
+    other.data = nullptr;
+    other.size = 0;
+    return *this;
+}
+
+/*! @} */
@@ -0,0 +1,48 @@
+/*!
+    \defgroup Mapped_submodule Отображение файла в память
+    \ingroup Dice_module
+    \brief Чтение файла без копирования через отображение в память
+*/
+#ifndef MAPPED_HPP
+#define MAPPED_HPP
+
+/*!
+    \addtogroup Mapped_submodule
+    @{
+*/
+
+#include <cstddef>
+#include <string>
+
+/*!
+    \brief Класс файла, отображённого в память
+    \details Объект MappedFile отображает файл в память только для чтения и освобождает отображение при уничтожении. В
+   системах без mmap файл читается в память целиком.
+*/
+class MappedFile
+{
+    private:
+        const char *data = nullptr;
+        size_t size = 0;
+        std::string buffer;
+
+        void unmap() noexcept;
+
+    public:
+        MappedFile() noexcept;
+        MappedFile(const std::string &path, const bool prefault = false);
+        MappedFile(const MappedFile &other) = delete;
+        MappedFile(MappedFile &&other) noexcept;
+
+        ~MappedFile() noexcept;
+
+        const char *get_data() const noexcept;
+        size_t get_size() const noexcept;
+
+        MappedFile &operator=(const MappedFile &other) = delete;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+};
+
+/*! @} */
+
+#endif // MAPPED_HPP
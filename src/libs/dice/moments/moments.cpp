@@ -0,0 +1,86 @@
+#include "moments.hpp"
+
+/*!
+    \addtogroup Moments_submodule
+    @{
+*/
+
+#include <cmath>
+#include <stdexcept>
+
+/*!
+    \brief Квантиль стандартного нормального распределения
+    \details Вычисляет начальное приближение рациональными функциями Акклама и уточняет его одним шагом Галлея по
+   функции erfc, что даёт почти полную точность double.
+
+    \param[in] p вероятность.
+
+    \return Число z, для которого P(Z <= z) = p.
+
+    \throw std::invalid_argument - если p не лежит в интервале (0, 1).
+*/
+double normal_quantile(const double p)
+{
+    if (!(p > 0 && p < 1))
+        throw std::invalid_argument("Probability must be in (0, 1)!");
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02,  -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01,  -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00,  2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    const double low = 0.02425;
+    double z;
+    if (p < low || p > 1 - low)
+    {
+        double q = std::sqrt(-2 * std::log(p < low ? p : 1 - p));
+        z = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+        if (p > 1 - low)
+            z = -z;
+    }
+    else
+    {
+        double q = p - 0.5, r = q * q;
+        z = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+    }
+    double e = 0.5 * std::erfc(-z / std::sqrt(2.0)) - p;
+    double u = e * std::sqrt(2 * std::acos(-1.0)) * std::exp(z * z / 2);
+    return z - u / (1 + z * u / 2);
+}
+
+/*!
+    \brief Приближённый квантиль
+    \details Приближает квантиль уровня p распределения с моментами moments. Нормальное приближение использует только
+   среднее и дисперсию. Разложение Корниша-Фишера добавляет поправки по кумулянтам третьего и четвёртого порядка и
+   точнее на хвостах сумм небольшого числа костей или костей с несимметричными шансами. Результат непрерывен и не
+   округляется до возможного значения суммы.
+
+    \param[in] moments ссылка на моменты распределения.
+    \param[in] p вероятность.
+    \param[in] method способ приближения.
+
+    \return Приближённое значение x, для которого P(X <= x) = p.
+
+    \throw std::invalid_argument - если p не лежит в интервале (0, 1).
+*/
+double approximate_quantile(const OddsMoments &moments, const double p, const QuantileMethod method)
+{
+    double z = normal_quantile(p);
+    if (moments.variance <= 0)
+        return moments.mean;
+    double sigma = std::sqrt(moments.variance);
+    if (method == QuantileMethod::edgeworth)
+    {
+        double skewness = moments.third / (moments.variance * sigma);
+        double kurtosis = moments.fourth / (moments.variance * moments.variance);
+        double z2 = z * z, z3 = z2 * z;
+        z += (z2 - 1) * skewness / 6 + (z3 - 3 * z) * kurtosis / 24 - (2 * z3 - 5 * z) * skewness * skewness / 36;
+    }
+    return moments.mean + sigma * z;
+}
+
+/*! @} */
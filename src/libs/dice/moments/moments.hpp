@@ -0,0 +1,31 @@
+/*!
+    \defgroup Moments_submodule Приближение распределения суммы
+    \ingroup Dice_module
+    \brief Квантили суммы значений по моментам без бросков
+*/
+#ifndef MOMENTS_HPP
+#define MOMENTS_HPP
+
+/*!
+    \addtogroup Moments_submodule
+    @{
+*/
+
+#include "../oneDice/odds/odds.hpp"
+
+/*!
+    \brief Способ приближения квантилей
+*/
+enum class QuantileMethod
+{
+    normal,   ///< Нормальное приближение по среднему и дисперсии
+    edgeworth ///< Разложение Корниша-Фишера, обращающее ряд Эджворта, с поправками на асимметрию и эксцесс
+};
+
+double normal_quantile(const double p);
+double approximate_quantile(const OddsMoments &moments, const double p,
+                            const QuantileMethod method = QuantileMethod::edgeworth);
+
+/*! @} */
+
+#endif // MOMENTS_HPP
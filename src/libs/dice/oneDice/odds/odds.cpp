@@ -6,32 +6,92 @@
 */
 
 #include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <limits>
 
+/*!
+    \brief Проверка шансов кости
+    \details Функция проверяет, что хотя бы одна грань может выпасть и сумма шансов помещается в Chance.
+
+    \param[in] odds_arr указатель на массив шансов кости.
+    \param[in] faces кол-во граней кости.
+
+    \return True если шансы корректны. Иначе False.
+*/
+bool check_odds(const Chance *odds_arr, const size_t faces)
+{
+    unsigned long long total = 0;
+    for (size_t i = 0; i < faces; ++i)
+        total += odds_arr[i];
+    return total > 0 && total <= std::numeric_limits<Chance>::max();
+}
+
+/*!
+    \brief Перевод вероятностей в шансы
+    \details Функция проверяет вероятности выпадения граней и переводит их в целые шансы с суммой probability_scale.
+   Остаток от округления распределяется между гранями с наибольшими дробными частями, поэтому сумма шансов точная.
+
+    \param[in] probabilities указатель на массив вероятностей выпадения.
+    \param[in] faces кол-во граней кости.
+    \param[out] odds_arr указатель на массив шансов кости.
+    \param[out] remainders указатель на массив для дробных частей размером faces.
+
+    \throw std::invalid_argument - если вероятность не лежит в [0, 1] или сумма вероятностей отличается от 1 больше
+   чем на odds_tolerance.
+*/
+void probabilities_to_odds(const double *probabilities, const size_t faces, Chance *odds_arr, double *remainders)
+{
+    double sum = 0;
+    for (size_t i = 0; i < faces; ++i)
+    {
+        if (!(probabilities[i] >= 0 && probabilities[i] <= 1))
+            throw std::invalid_argument("Invalid probability!");
+        sum += probabilities[i];
+    }
+    if (std::fabs(sum - 1) > odds_tolerance)
+        throw std::invalid_argument("Sum of probabilities must be 1!");
+
+    Chance total = 0;
+    for (size_t i = 0; i < faces; ++i)
+    {
+        double scaled = probabilities[i] / sum * probability_scale;
+        odds_arr[i] = std::min(static_cast<Chance>(scaled), probability_scale - total);
+        remainders[i] = scaled - odds_arr[i];
+        total += odds_arr[i];
+    }
+    for (; total < probability_scale; ++total)
+    {
+        size_t max_index = std::max_element(remainders, remainders + faces) - remainders;
+        ++odds_arr[max_index];
+        remainders[max_index] = -1;
+    }
+}
+
 /*!
     \brief Сеттер шансов кости
     \details Копирует массив шансов кости в объект Odds.
 
     \param[in] odds_arr указатель на массив шансов кости.
 
-    \throw std::invalid_argument - если значение в массиве < 0 или сумма значений массива > 1.
+    \throw std::invalid_argument - если сумма шансов равна 0 или не помещается в Chance.
 */
-void Odds::set_odds(const Chance *odds_arr)
+template <size_t Faces> void BasicOdds<Faces>::set_odds(const Chance *odds_arr)
 {
-    // check_odds(odds_arr);
-    std::copy(odds_arr, odds_arr + 6, odds);
+    if (!check_odds(odds_arr, Faces))
+        throw std::invalid_argument("Invalid odds!");
+    std::copy(odds_arr, odds_arr + Faces, odds);
 }
 
 /*!
     \brief Конструктор по умолчанию
-    \details Создаёт объект Odds с стандартными шансами кости (1/6 для каждой грани).
+    \details Создаёт объект Odds с стандартными шансами кости (1/Faces для каждой грани).
 */
-Odds::Odds()
+template <size_t Faces> BasicOdds<Faces>::BasicOdds()
 {
-    Chance standart_odds[6];
+    Chance standart_odds[Faces];
     Chance value = 1;
-    std::fill(standart_odds, standart_odds + 6, value);
+    std::fill(standart_odds, standart_odds + Faces, value);
     set_odds(standart_odds);
 }
 
@@ -41,20 +101,38 @@ Odds::Odds()
 
     \param[in] odds_arr указатель на массив шансов кости.
 
-    \throw std::invalid_argument - если значение в массиве < 0 или сумма значений массива > 1.
+    \throw std::invalid_argument - если сумма шансов равна 0 или не помещается в Chance.
 */
-Odds::Odds(const Chance *odds_arr)
+template <size_t Faces> BasicOdds<Faces>::BasicOdds(const Chance *odds_arr)
 {
     set_odds(odds_arr);
 }
 
+/*!
+    \brief Конструктор с вероятностями
+    \details Создаёт объект Odds по вероятностям выпадения граней. Вероятности один раз переводятся в целые шансы с
+   суммой probability_scale, поэтому выбор грани выполняется без вычислений с плавающей запятой.
+
+    \param[in] probabilities указатель на массив вероятностей выпадения граней.
+
+    \throw std::invalid_argument - если вероятность не лежит в [0, 1] или сумма вероятностей отличается от 1 больше
+   чем на odds_tolerance.
+*/
+template <size_t Faces> BasicOdds<Faces>::BasicOdds(const double *probabilities)
+{
+    Chance odds_arr[Faces];
+    double remainders[Faces];
+    probabilities_to_odds(probabilities, Faces, odds_arr, remainders);
+    set_odds(odds_arr);
+}
+
 /*!
     \brief Конструктор копирования
     \details Копирование обьектов класса Odds.
 
     \param[in] other ссылка на объект Odds, который нужно скопировать.
 */
-Odds::Odds(const Odds& other)
+template <size_t Faces> BasicOdds<Faces>::BasicOdds(const BasicOdds& other)
 {
     *this = other;
 }
@@ -65,7 +143,7 @@ Odds::Odds(const Odds& other)
 
     \param[in] other ссылка на объект Odds.
 */
-Odds::Odds(Odds&& other)
+template <size_t Faces> BasicOdds<Faces>::BasicOdds(BasicOdds&& other)
 {
     *this = std::move(other.odds);
 }
@@ -78,14 +156,45 @@ Odds::Odds(Odds&& other)
     
     \return Возвращает шанс грани.
 
-    \еthrow std::out_of_range - если index >= 6.
+    \еthrow std::out_of_range - если index >= Faces.
 */
-Chance Odds::get_odds(const size_t index) const
+template <size_t Faces> Chance BasicOdds<Faces>::get_odds(const size_t index) const
 {
-    if (index >= 6) throw std::out_of_range("Index out of range!");
+    if (index >= Faces) throw std::out_of_range("Index out of range!");
     return odds[index];
 }
 
+/*!
+    \brief Геттер моментов
+    \details Вычисляет моменты значения кости, считая значением грани её номер от 1 до Faces.
+
+    \return Математическое ожидание, дисперсия и кумулянты третьего и четвёртого порядка.
+*/
+template <size_t Faces> OddsMoments BasicOdds<Faces>::get_moments() const noexcept
+{
+    double total = 0, mean = 0;
+    for (size_t i = 0; i < Faces; ++i)
+    {
+        total += odds[i];
+        mean += static_cast<double>(odds[i]) * (i + 1);
+    }
+    mean /= total;
+    double second = 0, third = 0, fourth = 0;
+    for (size_t i = 0; i < Faces; ++i)
+    {
+        double p = odds[i] / total, d = (i + 1) - mean;
+        second += p * d * d;
+        third += p * d * d * d;
+        fourth += p * d * d * d * d;
+    }
+    OddsMoments moments;
+    moments.mean = mean;
+    moments.variance = second;
+    moments.third = third;
+    moments.fourth = fourth - 3 * second * second;
+    return moments;
+}
+
 /*!
     \brief Оператор []
     \details Перегрузка оператора [] для доступа к элементу массива шансов кости.
@@ -94,11 +203,11 @@ Chance Odds::get_odds(const size_t index) const
 
     \return ссылка на шанс выпадения грани кости.
     
-    \throw std::out_of_range - если index >= 6.
+    \throw std::out_of_range - если index >= Faces.
 */
-Chance &Odds::operator [] (const size_t index)
+template <size_t Faces> Chance &BasicOdds<Faces>::operator [] (const size_t index)
 {
-    if (index >= 6) throw std::out_of_range("Index out of range!");
+    if (index >= Faces) throw std::out_of_range("Index out of range!");
     return odds[index];
 }
 
@@ -110,11 +219,11 @@ Chance &Odds::operator [] (const size_t index)
 
     \return ссылка текущий обьект Odds.
 */
-Odds& Odds::operator=(const Odds& other)
+template <size_t Faces> BasicOdds<Faces>& BasicOdds<Faces>::operator=(const BasicOdds& other)
 {
     if (this != &other)
     {
-        std::copy(other.odds, other.odds + 6, odds);
+        std::copy(other.odds, other.odds + Faces, odds);
     }
     return *this;
 }
@@ -127,7 +236,7 @@ Odds& Odds::operator=(const Odds& other)
 
     \return ссылка текущий обьект Odds.
 */
-Odds& Odds::operator=(Odds&& other)
+template <size_t Faces> BasicOdds<Faces>& BasicOdds<Faces>::operator=(BasicOdds&& other)
 {
     *this = other;
     return *this;
@@ -144,10 +253,10 @@ Odds& Odds::operator=(Odds&& other)
 
     \throw std::invalid_argument - если введенное значение не является числом.
 */
-std::istream &operator >> (std::istream &input, Odds& odds)
+template <size_t Faces> std::istream &operator >> (std::istream &input, BasicOdds<Faces>& odds)
 {
-    Chance odds_arr[6];
-    for (size_t i = 0; i < 6; ++i)
+    Chance odds_arr[Faces];
+    for (size_t i = 0; i < Faces; ++i)
     {
         input >> odds_arr[i];
         if (input.fail())
@@ -170,16 +279,44 @@ std::istream &operator >> (std::istream &input, Odds& odds)
     
     \return Возвращает ссылку на выходной поток.
 */
-std::ostream &operator << (std::ostream &output, const Odds& odds)
+template <size_t Faces> std::ostream &operator << (std::ostream &output, const BasicOdds<Faces>& odds)
 {
     output << "{";
-    for (size_t i = 0; i < 6; ++i)
+    for (size_t i = 0; i < Faces; ++i)
     {
         output << odds.get_odds(i);
-        if (i < 5) output << ", ";
+        if (i + 1 < Faces) output << ", ";
     }
     output << "}";
     return output;
 }
 
+template class BasicOdds<4>;
+template std::istream &operator >> (std::istream &input, BasicOdds<4>& odds);
+template std::ostream &operator << (std::ostream &output, const BasicOdds<4>& odds);
+
+template class BasicOdds<6>;
+template std::istream &operator >> (std::istream &input, BasicOdds<6>& odds);
+template std::ostream &operator << (std::ostream &output, const BasicOdds<6>& odds);
+
+template class BasicOdds<8>;
+template std::istream &operator >> (std::istream &input, BasicOdds<8>& odds);
+template std::ostream &operator << (std::ostream &output, const BasicOdds<8>& odds);
+
+template class BasicOdds<10>;
+template std::istream &operator >> (std::istream &input, BasicOdds<10>& odds);
+template std::ostream &operator << (std::ostream &output, const BasicOdds<10>& odds);
+
+template class BasicOdds<12>;
+template std::istream &operator >> (std::istream &input, BasicOdds<12>& odds);
+template std::ostream &operator << (std::ostream &output, const BasicOdds<12>& odds);
+
+template class BasicOdds<20>;
+template std::istream &operator >> (std::istream &input, BasicOdds<20>& odds);
+template std::ostream &operator << (std::ostream &output, const BasicOdds<20>& odds);
+
+template class BasicOdds<100>;
+template std::istream &operator >> (std::istream &input, BasicOdds<100>& odds);
+template std::ostream &operator << (std::ostream &output, const BasicOdds<100>& odds);
+
 /*! @} */
\ No newline at end of file
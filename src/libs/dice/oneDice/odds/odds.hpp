@@ -1,4 +1,4 @@
-/*! 
+/*!
     \defgroup Odds_submodule Вероятности выпадения
     \ingroup OneDice_submodule
 */
@@ -13,33 +13,64 @@
 #include <cstddef>
 #include <iostream>
 
-typedef unsigned Chance; ///< Шанс выпадения для каждого значения
+typedef unsigned Chance;               ///< Шанс выпадения для каждого значения
+typedef unsigned short int NumPoints;  ///< Количество очков выпавшего значения
+typedef unsigned char PackedNumPoints; ///< Количество очков в плотном массиве значений
+
+constexpr double odds_tolerance = 1e-9;              ///< Допустимое отклонение суммы вероятностей от 1
+constexpr Chance probability_scale = Chance(1) << 31; ///< Сумма шансов, в которую переводятся вероятности
 
 /*!
-    \brief Класс для хранения вероятностей выпадения
-    \details Объект Odds хранит указатель на массив вероятностей выпадения.
+    \brief Моменты распределения значения кости
+    \details Математическое ожидание, дисперсия и кумулянты третьего и четвёртого порядка. Кумулянты суммы
+    независимых костей равны суммам кумулянтов отдельных костей.
 */
-class Odds
+struct OddsMoments
 {
+        double mean = 0;     ///< Математическое ожидание
+        double variance = 0; ///< Дисперсия
+        double third = 0;    ///< Кумулянт третьего порядка
+        double fourth = 0;   ///< Кумулянт четвёртого порядка
+};
+
+/*!
+    \brief Шаблон класса для хранения вероятностей выпадения
+    \details Объект BasicOdds хранит массив вероятностей выпадения для каждой из Faces граней. Размер массива известен
+    на этапе компиляции. Шаблон инстанцирован для костей с 4, 6, 8, 10, 12, 20 и 100 гранями.
+
+    \tparam Faces кол-во граней кости.
+*/
+template <size_t Faces> class BasicOdds
+{
+        static_assert(Faces >= 2, "Dice must have at least two faces");
+
     private:
-        Chance odds[6];
+        Chance odds[Faces];
         void set_odds(const Chance *odds_arr);
-        
+
     public:
-        Odds();
-        Odds(const Chance *odds_arr);
-        Odds(const Odds& other);
-        Odds(Odds&& other);
+        static constexpr size_t faces = Faces; ///< Кол-во граней кости
+
+        BasicOdds();
+        BasicOdds(const Chance *odds_arr);
+        BasicOdds(const double *probabilities);
+        BasicOdds(const BasicOdds& other);
+        BasicOdds(BasicOdds&& other);
 
         Chance get_odds(const size_t index) const;
+        OddsMoments get_moments() const noexcept;
 
         Chance &operator [] (const size_t index);
-        Odds& operator=(const Odds& other);
-        Odds& operator=(Odds&& other);
-        friend std::istream &operator >> (std::istream &input, Odds& odds);
-        friend std::ostream &operator << (std::ostream &output, const Odds& odds);
+        BasicOdds& operator=(const BasicOdds& other);
+        BasicOdds& operator=(BasicOdds&& other);
+        template <size_t N> friend std::istream &operator >> (std::istream &input, BasicOdds<N>& odds);
 };
 
+template <size_t Faces> std::istream &operator >> (std::istream &input, BasicOdds<Faces>& odds);
+template <size_t Faces> std::ostream &operator << (std::ostream &output, const BasicOdds<Faces>& odds);
+
+typedef BasicOdds<6> Odds; ///< Шансы выпадения шестигранной кости
+
 /*! @} */
 
 #endif // ODDS_HPP
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include "registry.hpp"
+
+/*!
+    \addtogroup OddsRegistry_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+constexpr size_t chunk_bits = 8;                       ///< Кол-во бит номера, адресующих запись внутри блока
+constexpr size_t chunk_size = size_t(1) << chunk_bits; ///< Кол-во записей в одном блоке реестра
+constexpr size_t max_chunks = (size_t(std::numeric_limits<OddsHandle>::max()) + 1) / chunk_size; ///< Кол-во блоков
+
+/*!
+    \brief Запись реестра
+    \details Хранит вероятности выпадения и вычисленные по ним таблицу выбора грани и моменты.
+*/
+template <size_t Faces> struct RegistryEntry
+{
+        BasicOdds<Faces> odds;
+        OddsTable<Faces> table;
+        OddsMoments moments;
+};
+
+/*!
+    \brief Заполнение таблицы выбора грани
+    \details Вычисляет пороги случайного 32-битного числа для каждой грани и, для костей с большим кол-вом граней,
+   направляющую таблицу.
+
+    \param[in] odds ссылка на вероятности выпадения.
+    \param[out] table ссылка на заполняемую таблицу.
+
+    \throw std::invalid_argument - если сумма шансов равна 0 или не помещается в Chance.
+*/
+template <size_t Faces> void fill_OddsTable(const BasicOdds<Faces> &odds, OddsTable<Faces> &table)
+{
+    unsigned long long total = 0;
+    for (size_t i = 0; i < Faces; ++i)
+        total += odds.get_odds(i);
+    if (total == 0)
+        throw std::invalid_argument("Sum of odds must be positive!");
+    if (total > std::numeric_limits<Chance>::max())
+        throw std::invalid_argument("Sum of odds is too large!");
+
+    unsigned long long prefix = 0;
+    table.fair = true;
+    table.last_face = 1;
+    for (size_t i = 0; i < Faces; ++i)
+    {
+        prefix += odds.get_odds(i);
+        if (i + 1 < Faces)
+        {
+            unsigned long long threshold = (prefix << 32) / total;
+            table.thresholds[i] = static_cast<RandomWord>(std::min(threshold, 0xFFFFFFFFULL));
+        }
+        if (odds.get_odds(i) != 0)
+            table.last_face = static_cast<NumPoints>(i + 1);
+        table.fair = table.fair && odds.get_odds(i) == odds.get_odds(0);
+    }
+    if constexpr (Faces > max_unrolled_faces)
+    {
+        NumPoints face = 1;
+        for (size_t bucket = 0; bucket < (size_t(1) << odds_guide_bits); ++bucket)
+        {
+            RandomWord lowest = static_cast<RandomWord>(bucket << (32 - odds_guide_bits));
+            while (face < Faces && table.thresholds[face - 1] <= lowest)
+                ++face;
+            table.guide[bucket] = face;
+        }
+    }
+}
+
+/*!
+    \brief Хранилище реестра
+    \details Записи хранятся блоками фиксированного размера, которые никогда не перемещаются. Поиск уже добавленных
+    вероятностей выполняется по словарю под мьютексом, чтение записей по номеру выполняется без блокировок.
+*/
+template <size_t Faces> struct RegistryStorage
+{
+        std::mutex mutex;
+        std::map<std::array<Chance, Faces>, OddsHandle> handles;
+        std::atomic<RegistryEntry<Faces> *> chunks[max_chunks];
+        std::atomic<size_t> size;
+
+        RegistryStorage();
+        ~RegistryStorage();
+
+        OddsHandle add(const BasicOdds<Faces> &odds);
+};
+
+/*!
+    \brief Конструктор хранилища
+    \details Создаёт хранилище и добавляет в него "честную" кость под номером fair_odds_handle.
+*/
+template <size_t Faces> RegistryStorage<Faces>::RegistryStorage() : size(0)
+{
+    for (std::atomic<RegistryEntry<Faces> *> &chunk : chunks)
+        chunk.store(nullptr, std::memory_order_relaxed);
+    add(BasicOdds<Faces>());
+}
+
+/*!
+    \brief Деструктор хранилища
+    \details Освобождает все блоки записей.
+*/
+template <size_t Faces> RegistryStorage<Faces>::~RegistryStorage()
+{
+    for (std::atomic<RegistryEntry<Faces> *> &chunk : chunks)
+        delete[] chunk.load(std::memory_order_relaxed);
+}
+
+/*!
+    \brief Добавление записи
+    \details Добавляет в хранилище вероятности odds под следующим свободным номером. Вызывается под мьютексом
+   хранилища.
+
+    \param[in] odds ссылка на вероятности выпадения.
+
+    \return Номер добавленной записи.
+
+    \throw std::invalid_argument - если сумма шансов равна 0 или не помещается в Chance.
+    \throw std::length_error - если в реестре закончились номера.
+*/
+template <size_t Faces> OddsHandle RegistryStorage<Faces>::add(const BasicOdds<Faces> &odds)
+{
+    size_t handle = size.load(std::memory_order_relaxed);
+    if (handle >= max_chunks * chunk_size)
+        throw std::length_error("Too many odds in registry!");
+    OddsTable<Faces> table;
+    fill_OddsTable(odds, table);
+
+    RegistryEntry<Faces> *chunk = chunks[handle >> chunk_bits].load(std::memory_order_relaxed);
+    if (chunk == nullptr)
+    {
+        chunk = new RegistryEntry<Faces>[chunk_size];
+        chunks[handle >> chunk_bits].store(chunk, std::memory_order_relaxed);
+    }
+    RegistryEntry<Faces> &entry = chunk[handle & (chunk_size - 1)];
+    entry.odds = odds;
+    entry.table = table;
+    entry.moments = odds.get_moments();
+
+    std::array<Chance, Faces> key;
+    for (size_t i = 0; i < Faces; ++i)
+        key[i] = odds.get_odds(i);
+    handles.emplace(key, static_cast<OddsHandle>(handle));
+    size.store(handle + 1, std::memory_order_release);
+    return static_cast<OddsHandle>(handle);
+}
+
+/*!
+    \brief Хранилище реестра
+    \details Возвращает единственное хранилище реестра для костей с Faces гранями.
+
+    \return Ссылка на хранилище.
+*/
+template <size_t Faces> RegistryStorage<Faces> &get_storage()
+{
+    static RegistryStorage<Faces> storage;
+    return storage;
+}
+
+/*!
+    \brief Добавление вероятностей в реестр
+    \details Ищет в реестре такие же вероятности выпадения. Если их нет, добавляет их и вычисляет таблицу выбора грани.
+
+    \param[in] odds ссылка на вероятности выпадения.
+
+    \return Номер вероятностей в реестре.
+
+    \throw std::invalid_argument - если сумма шансов равна 0 или не помещается в Chance.
+    \throw std::length_error - если в реестре закончились номера.
+*/
+template <size_t Faces> OddsHandle OddsRegistry<Faces>::intern(const BasicOdds<Faces> &odds)
+{
+    RegistryStorage<Faces> &storage = get_storage<Faces>();
+    std::array<Chance, Faces> key;
+    for (size_t i = 0; i < Faces; ++i)
+        key[i] = odds.get_odds(i);
+
+    std::lock_guard<std::mutex> lock(storage.mutex);
+    typename std::map<std::array<Chance, Faces>, OddsHandle>::const_iterator found = storage.handles.find(key);
+    if (found != storage.handles.cend())
+        return found->second;
+    return storage.add(odds);
+}
+
+/*!
+    \brief Поиск записи реестра
+    \details Возвращает запись реестра с номером handle.
+
+    \param[in] handle номер вероятностей в реестре.
+
+    \return Ссылка на запись реестра.
+
+    \throw std::out_of_range - если в реестре нет записи с номером handle.
+*/
+template <size_t Faces> const RegistryEntry<Faces> &get_entry(const OddsHandle handle)
+{
+    RegistryStorage<Faces> &storage = get_storage<Faces>();
+    if (handle >= storage.size.load(std::memory_order_acquire))
+        throw std::out_of_range("Unknown odds handle!");
+    return storage.chunks[handle >> chunk_bits].load(std::memory_order_relaxed)[handle & (chunk_size - 1)];
+}
+
+/*!
+    \brief Геттер вероятностей выпадения
+    \details Возвращает вероятности выпадения с номером handle.
+
+    \param[in] handle номер вероятностей в реестре.
+
+    \return Ссылка на вероятности выпадения.
+
+    \throw std::out_of_range - если в реестре нет записи с номером handle.
+*/
+template <size_t Faces> const BasicOdds<Faces> &OddsRegistry<Faces>::get_odds(const OddsHandle handle)
+{
+    return get_entry<Faces>(handle).odds;
+}
+
+/*!
+    \brief Геттер таблицы выбора грани
+    \details Возвращает таблицу выбора грани для вероятностей с номером handle.
+
+    \param[in] handle номер вероятностей в реестре.
+
+    \return Ссылка на таблицу выбора грани.
+
+    \throw std::out_of_range - если в реестре нет записи с номером handle.
+*/
+template <size_t Faces> const OddsTable<Faces> &OddsRegistry<Faces>::get_table(const OddsHandle handle)
+{
+    return get_entry<Faces>(handle).table;
+}
+
+/*!
+    \brief Геттер моментов
+    \details Возвращает моменты, вычисленные при добавлении вероятностей с номером handle в реестр.
+
+    \param[in] handle номер вероятностей в реестре.
+
+    \return Ссылка на моменты значения кости.
+
+    \throw std::out_of_range - если в реестре нет записи с номером handle.
+*/
+template <size_t Faces> const OddsMoments &OddsRegistry<Faces>::get_moments(const OddsHandle handle)
+{
+    return get_entry<Faces>(handle).moments;
+}
+
+/*!
+    \brief Геттер размера реестра
+    \details Возвращает кол-во различных вероятностей выпадения в реестре.
+
+    \return Кол-во записей реестра.
+*/
+template <size_t Faces> size_t OddsRegistry<Faces>::get_size() noexcept
+{
+    return get_storage<Faces>().size.load(std::memory_order_acquire);
+}
+
+template class OddsRegistry<4>;
+template class OddsRegistry<6>;
+template class OddsRegistry<8>;
+template class OddsRegistry<10>;
+template class OddsRegistry<12>;
+template class OddsRegistry<20>;
+template class OddsRegistry<100>;
+
+template void fill_OddsTable(const BasicOdds<4> &odds, OddsTable<4> &table);
+template void fill_OddsTable(const BasicOdds<6> &odds, OddsTable<6> &table);
+template void fill_OddsTable(const BasicOdds<8> &odds, OddsTable<8> &table);
+template void fill_OddsTable(const BasicOdds<10> &odds, OddsTable<10> &table);
+template void fill_OddsTable(const BasicOdds<12> &odds, OddsTable<12> &table);
+template void fill_OddsTable(const BasicOdds<20> &odds, OddsTable<20> &table);
+template void fill_OddsTable(const BasicOdds<100> &odds, OddsTable<100> &table);
+
+/*! @} */
@@ -0,0 +1,71 @@
+/*!
+    \defgroup OddsRegistry_submodule Реестр вероятностей выпадения
+    \ingroup Odds_submodule
+    \brief Общие для всех костей вероятности выпадения
+*/
+#ifndef ODDS_REGISTRY_HPP
+#define ODDS_REGISTRY_HPP
+
+/*!
+    \addtogroup OddsRegistry_submodule
+    @{
+*/
+
+#include <cstdint>
+
+#include "../../../random/random.hpp"
+#include "../odds.hpp"
+
+typedef std::uint16_t OddsHandle; ///< Номер вероятностей выпадения в реестре
+
+constexpr OddsHandle fair_odds_handle = 0; ///< Номер вероятностей "честной" кости
+
+/*!
+    \brief Кол-во граней, до которого поиск грани разворачивается на этапе компиляции
+    \details Для костей с большим кол-вом граней поиск начинается с грани из направляющей таблицы.
+*/
+constexpr size_t max_unrolled_faces = 20;
+constexpr size_t odds_guide_bits = 8; ///< Кол-во старших бит случайного числа, адресующих направляющую таблицу
+
+/*!
+    \brief Таблица для выбора грани
+    \details Хранит пороги случайного 32-битного числа, вычисленные один раз при добавлении вероятностей в реестр.
+    Выпавшая грань равна кол-ву порогов, не превышающих случайное число, плюс один, но не больше last_face. Если сумма
+    шансов - степень двойки, пороги точные, иначе погрешность вероятности каждой грани не превышает 2^-32. Для костей с
+    более чем max_unrolled_faces гранями таблица также хранит для каждого значения старших odds_guide_bits бит
+    случайного числа наименьшую возможную грань, с которой начинается поиск.
+
+    \tparam Faces кол-во граней кости.
+*/
+template <size_t Faces> struct OddsTable
+{
+        RandomWord thresholds[Faces - 1]; ///< Минимальное случайное число для граней 2..Faces
+        NumPoints guide[Faces > max_unrolled_faces ? size_t(1) << odds_guide_bits : 1]; ///< Начальные грани поиска
+        NumPoints last_face;              ///< Последняя грань с ненулевым шансом
+        bool fair;                        ///< True, если все грани равновероятны
+};
+
+/*!
+    \brief Реестр вероятностей выпадения
+    \details Хранит по одному экземпляру каждого набора вероятностей выпадения. Кости хранят только номер набора в
+    реестре. Номер fair_odds_handle всегда соответствует "честной" кости. Добавленные наборы не удаляются и не
+    перемещаются в памяти, поэтому чтение из реестра безопасно параллельно с добавлением.
+
+    \tparam Faces кол-во граней кости.
+*/
+template <size_t Faces> class OddsRegistry
+{
+    public:
+        static OddsHandle intern(const BasicOdds<Faces> &odds);
+
+        static const BasicOdds<Faces> &get_odds(const OddsHandle handle);
+        static const OddsTable<Faces> &get_table(const OddsHandle handle);
+        static const OddsMoments &get_moments(const OddsHandle handle);
+        static size_t get_size() noexcept;
+};
+
+template <size_t Faces> void fill_OddsTable(const BasicOdds<Faces> &odds, OddsTable<Faces> &table);
+
+/*! @} */
+
+#endif // ODDS_REGISTRY_HPP
@@ -1,4 +1,5 @@
 #include "oneDice.hpp"
+#include "../journal/journal.hpp"
 
 /*!
     \addtogroup OneDice_submodule
@@ -8,34 +9,40 @@
 #include <algorithm>
 #include <cstring>
 #include <limits>
+#include <cstdio>
 #include <random>
+#include <utility>
 
 /*!
     \brief Проверка выпавшего числа кости
     \details Функция проверяет правильность выпавшего числа кости.
 
+    \tparam Faces кол-во граней кости.
+
     \param[in] num значение кости.
 
-    \return True если значение 1 <= num <= 6. Иначе False.
+    \return True если значение 1 <= num <= Faces. Иначе False.
 */
-bool check_NumPoints(const NumPoints num)
+template <size_t Faces> bool check_NumPoints(const NumPoints num)
 {
-    return num >= 1 && num <= 6;
+    return num >= 1 && num <= Faces;
 }
 
 /*!
     \brief Генератор AsciiArt
-    \details Функция выбирает AscciArt в виде строки в зависимости от значения аргумента num.
+    \details Функция выбирает AscciArt в виде строки в зависимости от значения аргумента num. Значения от 1 до 6
+   изображаются точками, большие значения - числом на грани.
 
     \param[in] num значение кости.
+    \param[in] faces кол-во граней кости.
 
     \return Строка с ASCII-изображением.
 
-    \throw std::invalid_argument - если num == 0 или num > 6.
+    \throw std::invalid_argument - если num == 0 или num > faces.
 */
-AsciiArt NumPoints_to_AsciiArt(const NumPoints num)
+AsciiArt NumPoints_to_AsciiArt(const NumPoints num, const size_t faces)
 {
-    if (!check_NumPoints(num))
+    if (num == 0 || num > faces)
         throw std::invalid_argument("Invalid argument num!");
     const char *arts[6][8] = {{"   ________ ", "  /       /|", " /       / |", "/_______/  |", "|       |  /",
                                "|   o   | / ", "|       |/  ", "L_______/   "},
@@ -51,63 +58,221 @@ AsciiArt NumPoints_to_AsciiArt(const NumPoints num)
                                "|  o o  | / ", "|  o o  |/  ", "L_______/   "}};
 
     AsciiArt result;
-    for (const char *line : arts[num - 1])
-        result.add_line(line);
+    if (num <= 6)
+    {
+        for (const char *line : arts[num - 1])
+            result.add_line(line);
+        return result;
+    }
 
+    char digits[8];
+    int len = std::snprintf(digits, sizeof(digits), "%hu", num);
+    char number_line[] = "|       | / ";
+    std::copy(digits, digits + len, number_line + 1 + (7 - len) / 2);
+    for (size_t i = 0; i < 8; ++i)
+        result.add_line(i == 5 ? number_line : arts[0][i]);
     return result;
 }
 
 /*!
     \brief Поиск значения кости с учётом шанса
-    \details Функция ищет значение кости в зависимости от рандомного числа и максимальных значений выпадения.
+    \details Функция двоичным поиском ищет значение кости в зависимости от случайного числа и порогов выпадения граней.
+   Используется для костей с произвольным кол-вом граней.
 
-    \param[in] prefix указатель на массив максимальных значений случайного числа для каждой грани.
+    \param[in] thresholds указатель на массив порогов случайного числа для граней 2..faces.
+    \param[in] faces кол-во граней кости.
     \param[in] random_num случайное число.
 
     \return Случайная грань кости.
 */
-NumPoints find_value(const Chance *prefix, const NumPoints random_num)
+NumPoints find_value(const RandomWord *thresholds, const size_t faces, const RandomWord random_num)
 {
-    NumPoints mid;
-    NumPoints left = 0, right = 5;
+    size_t mid;
+    size_t left = 0, right = faces - 1;
     while (left < right)
     {
         mid = left + ((right - left) >> 1);
-        if (random_num > prefix[mid])
+        if (random_num >= thresholds[mid])
             left = mid + 1;
         else
             right = mid;
     }
-    return left + 1;
+    return static_cast<NumPoints>(left + 1);
+}
+
+/*!
+    \brief Поиск значения кости с учётом шанса
+    \details Развёрнутый на этапе компиляции поиск без ветвлений: значение кости равно кол-ву порогов, не
+   превышающих random_num, плюс один.
+
+    \param[in] thresholds указатель на массив порогов случайного числа для граней 2..Faces.
+    \param[in] random_num случайное число.
+
+    \return Случайная грань кости.
+*/
+template <size_t... Index>
+NumPoints find_value(const RandomWord *thresholds, const RandomWord random_num, std::index_sequence<Index...>)
+{
+    return static_cast<NumPoints>((1 + ... + static_cast<NumPoints>(random_num >= thresholds[Index])));
+}
+
+/*!
+    \brief Поиск значения кости по направляющей таблице
+    \details Начинает поиск с наименьшей грани, возможной для старших odds_guide_bits бит random_num, и проверяет
+   следующие пороги по одному. Обычно проверяется не больше одного-двух порогов.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] table ссылка на таблицу выбора грани.
+    \param[in] random_num случайное число.
+
+    \return Случайная грань кости.
+*/
+template <size_t Faces> NumPoints find_value(const OddsTable<Faces> &table, const RandomWord random_num)
+{
+    NumPoints face = table.guide[random_num >> (32 - odds_guide_bits)];
+    while (face < Faces && random_num >= table.thresholds[face - 1])
+        ++face;
+    return face;
+}
+
+/*!
+    \brief Выбор случайной грани "честной" кости
+    \details Функция отображает случайное 32-битное число на грани умножением и сдвигом, без деления.
+
+    \tparam Faces кол-во граней кости.
+
+    \return Случайная грань кости.
+*/
+template <size_t Faces> NumPoints random_fair_face()
+{
+    return static_cast<NumPoints>(((static_cast<std::uint64_t>(random_word()) * Faces) >> 32) + 1);
+}
+
+/*!
+    \brief Выбор случайной грани по таблице
+    \details Функция генерирует случайную грань кости по таблице выбора грани. Для равновероятных граней таблица не
+   используется. Для костей с не более чем max_unrolled_faces гранями поиск грани разворачивается на этапе компиляции,
+   для остальных начинается с грани из направляющей таблицы.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] table ссылка на таблицу выбора грани.
+
+    \return Случайная грань кости.
+*/
+template <size_t Faces> NumPoints random_face(const OddsTable<Faces> &table)
+{
+    if (table.fair)
+        return random_fair_face<Faces>();
+    RandomWord random_num = random_word();
+    NumPoints face;
+    if constexpr (Faces <= max_unrolled_faces)
+        face = find_value(table.thresholds, random_num, std::make_index_sequence<Faces - 1>());
+    else
+        face = find_value(table, random_num);
+    return std::min(face, table.last_face);
+}
+
+/*!
+    \brief Генератор случайной грани кости без смещения
+    \details Функция выбирает случайное число из [0, сумма шансов) без смещения и ищет грань по суммам шансов.
+   Вероятность каждой грани в точности равна её доле в сумме шансов.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] input_odds ссылка на шансы выпадения граней.
+
+    \return Случайная грань кости.
+
+    \throw std::invalid_argument - если сумма шансов равна 0.
+*/
+template <size_t Faces> NumPoints random_odds_exact(const BasicOdds<Faces> &input_odds)
+{
+    Chance total = 0;
+    for (size_t i = 0; i < Faces; ++i)
+        total += input_odds.get_odds(i);
+    Chance random_num = random_below(total);
+    NumPoints face = 1;
+    for (Chance prefix = input_odds.get_odds(0); random_num >= prefix; ++face)
+        prefix += input_odds.get_odds(face);
+    return face;
 }
 
 /*!
     \brief Генератор случайной грани кости
-    \details Функция генерирует случайную грань кости в соответствии с заданными шансами.
+    \details Функция генерирует случайную грань кости в соответствии с заданными шансами. Если источником случайных
+   чисел выбрана энтропия, грань выбирается без смещения.
+
+    \tparam Faces кол-во граней кости.
 
     \param[in] input_odds ссылка на шансы выпадения граней.
 
     \return Случайная грань кости.
+
+    \throw std::invalid_argument - если сумма шансов равна 0.
+*/
+template <size_t Faces> NumPoints random_odds(const BasicOdds<Faces> &input_odds)
+{
+    if (get_random_source() == RandomSource::entropy)
+        return random_odds_exact(input_odds);
+    OddsTable<Faces> table;
+    fill_OddsTable(input_odds, table);
+    return random_face(table);
+}
+
+/*!
+    \brief Генератор случайной грани кости
+    \details Функция генерирует случайную грань кости в соответствии с шансами из реестра. Для "честной" кости реестр
+   не используется. Если источником случайных чисел выбрана энтропия, грань выбирается без смещения.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] handle номер шансов выпадения граней в реестре.
+
+    \return Случайная грань кости.
+
+    \throw std::out_of_range - если в реестре нет шансов с номером handle.
 */
-NumPoints random_odds(const Odds &input_odds)
+template <size_t Faces> NumPoints random_odds(const OddsHandle handle)
 {
-    Chance prefix[6];
-    prefix[0] = input_odds.get_odds(0);
-    for (size_t i = 1; i < 6; ++i)
-        prefix[i] = prefix[i - 1] + input_odds.get_odds(i);
-    NumPoints random_num = (rand() % prefix[5]) + 1;
-    return find_value(prefix, random_num);
+    if (get_random_source() == RandomSource::entropy)
+    {
+        if (handle == fair_odds_handle)
+            return static_cast<NumPoints>(random_below(Faces) + 1);
+        return random_odds_exact(OddsRegistry<Faces>::get_odds(handle));
+    }
+    if (handle == fair_odds_handle)
+        return random_fair_face<Faces>();
+    return random_face(OddsRegistry<Faces>::get_table(handle));
 }
 
 /*!
     \brief Сеттер шансов кости
-    \details Помещает шансы кости в объект класса OneDice.
+    \details Добавляет шансы кости в реестр и сохраняет в объекте класса OneDice их номер.
 
     \param[in] input_odds ссылка на объект Odds, содержащий шансы кости.
+
+    \throw std::invalid_argument - если сумма шансов равна 0.
+*/
+template <size_t Faces> void BasicOneDice<Faces>::set_odds(const BasicOdds<Faces> &input_odds)
+{
+    odds = OddsRegistry<Faces>::intern(input_odds);
+}
+
+/*!
+    \brief Сеттер номера шансов кости
+    \details Сохраняет в объекте класса OneDice номер уже добавленных в реестр шансов.
+
+    \param[in] handle номер шансов кости в реестре.
+
+    \throw std::out_of_range - если в реестре нет шансов с номером handle.
 */
-void OneDice::set_odds(const Odds &input_odds)
+template <size_t Faces> void BasicOneDice<Faces>::set_odds_handle(const OddsHandle handle)
 {
-    odds = input_odds;
+    if (handle >= OddsRegistry<Faces>::get_size())
+        throw std::out_of_range("Unknown odds handle!");
+    odds = handle;
 }
 
 /*!
@@ -116,15 +281,24 @@ void OneDice::set_odds(const Odds &input_odds)
 
     \param[in] input_value значение кости.
 
-    \throw std::invalid_argument - если значение кости < 1 или > 6.
+    \throw std::invalid_argument - если значение кости < 1 или > Faces.
 */
-void OneDice::set_value(const NumPoints input_value)
+template <size_t Faces> void BasicOneDice<Faces>::set_value(const NumPoints input_value)
 {
-    if (!check_NumPoints(input_value))
+    if (!check_NumPoints<Faces>(input_value))
         throw std::invalid_argument("Invalid value!");
     value = input_value;
 }
 
+/*!
+    \brief Стандартный конструктор
+    \details Создаёт "честную" кость. Значение сразу генерируется.
+*/
+template <size_t Faces> BasicOneDice<Faces>::BasicOneDice()
+{
+    to_change_value();
+}
+
 /*!
     \brief Конструктор с пользовательским шансами
     \details Создаёт класс OneDice шансы выпадения каждого числа в котором передаются по ссылке input_odds. Значение
@@ -132,12 +306,25 @@ void OneDice::set_value(const NumPoints input_value)
 
     \param[in] input_odds ссылка на объект Odds, содержащий шансы кости.
 */
-OneDice::OneDice(const Odds &input_odds)
+template <size_t Faces> BasicOneDice<Faces>::BasicOneDice(const BasicOdds<Faces> &input_odds)
 {
     set_odds(input_odds);
     to_change_value();
 }
 
+/*!
+    \brief Конструктор с выпавшим значением
+    \details Создаёт "честную" кость со значением input_value.
+
+    \param[in] input_value значение кости.
+
+    \throw std::invalid_argument - если значение кости < 1 или > Faces.
+*/
+template <size_t Faces> BasicOneDice<Faces>::BasicOneDice(const NumPoints input_value)
+{
+    set_value(input_value);
+}
+
 /*!
     \brief Конструктор с пользовательским шансами и выпавшим значением
     \details Создаёт класс OneDice шансы выпадения каждого числа в котором передаются по ссылке input_odds. Значение
@@ -145,7 +332,8 @@ OneDice::OneDice(const Odds &input_odds)
 
     \param[in] input_odds ссылка на объект Odds, содержащий шансы кости.
 */
-OneDice::OneDice(const NumPoints input_value, const Odds &input_odds)
+template <size_t Faces>
+BasicOneDice<Faces>::BasicOneDice(const NumPoints input_value, const BasicOdds<Faces> &input_odds)
 {
     set_odds(input_odds);
     set_value(input_value);
@@ -157,7 +345,7 @@ OneDice::OneDice(const NumPoints input_value, const Odds &input_odds)
 
     \param[in] other ссылка на другой объект OneDice.
 */
-OneDice::OneDice(const OneDice &other)
+template <size_t Faces> BasicOneDice<Faces>::BasicOneDice(const BasicOneDice &other)
 {
     *this = other;
 }
@@ -168,7 +356,7 @@ OneDice::OneDice(const OneDice &other)
 
     \param[in] other ссылка на другой объект OneDice.
 */
-OneDice::OneDice(OneDice &&other)
+template <size_t Faces> BasicOneDice<Faces>::BasicOneDice(BasicOneDice &&other)
 {
     *this = std::move(other);
 }
@@ -179,7 +367,7 @@ OneDice::OneDice(OneDice &&other)
 
     \return Текущее значение кости.
 */
-NumPoints OneDice::get_value() const
+template <size_t Faces> NumPoints BasicOneDice<Faces>::get_value() const
 {
     return value;
 }
@@ -190,32 +378,44 @@ NumPoints OneDice::get_value() const
 
     \return AsciiArt с текущим значением кости.
 */
-AsciiArt OneDice::get_value_AsciiArt() const
+template <size_t Faces> AsciiArt BasicOneDice<Faces>::get_value_AsciiArt() const
 {
-    return NumPoints_to_AsciiArt(value);
+    return NumPoints_to_AsciiArt(value, Faces);
 }
 
 /*!
     \brief Геттер шансов кости
-    \details Возвращает копию текущих шансов кости.
+    \details Возвращает копию текущих шансов кости из реестра.
 
     \return Копия текущих шансов кости.
 */
-Odds OneDice::get_odds() const
+template <size_t Faces> BasicOdds<Faces> BasicOneDice<Faces>::get_odds() const
 {
-    return Odds(odds);
+    return BasicOdds<Faces>(OddsRegistry<Faces>::get_odds(odds));
 }
 
 /*!
-    \brief Конструктор с пользовательским шансами и
-    \details Создаёт класс OneDice шансы выпадения каждого числа в котором передаются по ссылке input_odds. Значение
-   сразу генерируется.
+    \brief Геттер номера шансов кости
+    \details Возвращает номер текущих шансов кости в реестре.
 
-    \param[in] input_odds ссылка на объект Odds, содержащий шансы кости.
+    \return Номер шансов кости.
+*/
+template <size_t Faces> OddsHandle BasicOneDice<Faces>::get_odds_handle() const noexcept
+{
+    return odds;
+}
+
+/*!
+    \brief Бросок кости
+    \details Генерирует новое значение кости по её шансам из реестра с помощью random_odds и, если включён журнал
+   бросков, записывает его в журнал.
+
+    \return Новое значение кости.
 */
-NumPoints OneDice::to_change_value()
+template <size_t Faces> NumPoints BasicOneDice<Faces>::to_change_value()
 {
-    value = random_odds(odds);
+    value = random_odds<Faces>(odds);
+    journal_roll(journal_no_index, value, Faces);
     return value;
 }
 
@@ -227,7 +427,7 @@ NumPoints OneDice::to_change_value()
 
     \return true - если выпавшее значение обоих объектов совпадает, иначе false.
 */
-bool OneDice::operator==(const OneDice &other) const
+template <size_t Faces> bool BasicOneDice<Faces>::operator==(const BasicOneDice &other) const
 {
     return value == other.value;
 }
@@ -238,12 +438,13 @@ bool OneDice::operator==(const OneDice &other) const
 
     \param[in] input ссылка на поток ввода.
 
-    \throw std::invalid_argument - если введенное значение кости < 1 или > 6.
+    \throw std::invalid_argument - если введенное значение кости < 1 или > Faces.
 */
-void OneDice::input(std::istream &input)
+template <size_t Faces> void BasicOneDice<Faces>::input(std::istream &input)
 {
     NumPoints input_value;
-    input >> input_value >> odds;
+    BasicOdds<Faces> input_odds;
+    input >> input_value >> input_odds;
     if (input.fail())
     {
         input.clear();
@@ -251,6 +452,7 @@ void OneDice::input(std::istream &input)
         throw std::invalid_argument("Invalid input value!");
     }
     set_value(input_value);
+    set_odds(input_odds);
 }
 
 /*!
@@ -259,9 +461,9 @@ void OneDice::input(std::istream &input)
 
     \param[in] out ссылка на поток вывода.
 */
-void OneDice::output(std::ostream &out) const
+template <size_t Faces> void BasicOneDice<Faces>::output(std::ostream &out) const
 {
-    out << "{value: " << value << "; odds: " << odds << "}";
+    out << "{value: " << value << "; odds: " << OddsRegistry<Faces>::get_odds(odds) << "}";
 }
 
 /*!
@@ -272,7 +474,7 @@ void OneDice::output(std::ostream &out) const
 
     \return Ссылка на текущий объект.
 */
-OneDice &OneDice::operator=(const OneDice &other)
+template <size_t Faces> BasicOneDice<Faces> &BasicOneDice<Faces>::operator=(const BasicOneDice &other)
 {
     if (this == &other)
         return *this;
@@ -289,10 +491,10 @@ OneDice &OneDice::operator=(const OneDice &other)
 
     \return Ссылка на текущий объект.
 */
-OneDice &OneDice::operator=(OneDice &&other)
+template <size_t Faces> BasicOneDice<Faces> &BasicOneDice<Faces>::operator=(BasicOneDice &&other)
 {
     value = std::move(other.value);
-    odds = std::move(other.odds);
+    odds = other.odds;
     other.value = 0;
     return *this;
 }
@@ -306,7 +508,7 @@ OneDice &OneDice::operator=(OneDice &&other)
 
     \return Ссылка на поток ввода.
 */
-std::istream &operator>>(std::istream &input, OneDice &dice)
+template <size_t Faces> std::istream &operator>>(std::istream &input, BasicOneDice<Faces> &dice)
 {
     dice.input(input);
     return input;
@@ -321,10 +523,256 @@ std::istream &operator>>(std::istream &input, OneDice &dice)
 
     \return Ссылка на поток вывода.
 */
-std::ostream &operator<<(std::ostream &output, const OneDice &dice)
+template <size_t Faces> std::ostream &operator<<(std::ostream &output, const BasicOneDice<Faces> &dice)
 {
     dice.output(output);
     return output;
 }
 
+/*!
+    \brief Конструктор "честной" кости
+    \details Создаёт "честную" кость с faces гранями. Значение сразу генерируется.
+
+    \param[in] faces кол-во граней кости.
+
+    \throw std::invalid_argument - если faces < 2 или faces больше максимального значения NumPoints.
+*/
+RuntimeOneDice::RuntimeOneDice(const size_t faces)
+{
+    if (faces < 2 || faces > std::numeric_limits<NumPoints>::max())
+        throw std::invalid_argument("Invalid number of faces!");
+    Vector<Chance> fair_odds(faces, 1);
+    set_odds(fair_odds.get_data(), faces);
+    to_change_value();
+}
+
+/*!
+    \brief Конструктор с пользовательскими шансами
+    \details Создаёт кость с faces гранями и шансами из массива odds_arr. Значение сразу генерируется.
+
+    \param[in] odds_arr указатель на массив из faces шансов.
+    \param[in] faces кол-во граней кости.
+
+    \throw std::invalid_argument - если кол-во граней неверно, сумма шансов равна 0 или не помещается в Chance.
+*/
+RuntimeOneDice::RuntimeOneDice(const Chance *odds_arr, const size_t faces)
+{
+    set_odds(odds_arr, faces);
+    to_change_value();
+}
+
+/*!
+    \brief Конструктор с выпавшим значением
+    \details Создаёт "честную" кость с faces гранями и значением input_value.
+
+    \param[in] input_value значение кости.
+    \param[in] faces кол-во граней кости.
+
+    \throw std::invalid_argument - если кол-во граней неверно или значение кости < 1 или > faces.
+*/
+RuntimeOneDice::RuntimeOneDice(const NumPoints input_value, const size_t faces)
+{
+    if (faces < 2 || faces > std::numeric_limits<NumPoints>::max())
+        throw std::invalid_argument("Invalid number of faces!");
+    Vector<Chance> fair_odds(faces, 1);
+    set_odds(fair_odds.get_data(), faces);
+    set_value(input_value);
+}
+
+/*!
+    \brief Сеттер шансов кости
+    \details Сохраняет шансы кости и вычисляет пороги случайного 32-битного числа для каждой грани, как
+   fill_OddsTable. Значение кости сохраняется, если оно не больше нового кол-ва граней, иначе генерируется заново.
+
+    \param[in] odds_arr указатель на массив из faces шансов.
+    \param[in] faces кол-во граней кости.
+
+    \throw std::invalid_argument - если кол-во граней неверно, сумма шансов равна 0 или не помещается в Chance.
+*/
+void RuntimeOneDice::set_odds(const Chance *odds_arr, const size_t faces)
+{
+    if (faces < 2 || faces > std::numeric_limits<NumPoints>::max())
+        throw std::invalid_argument("Invalid number of faces!");
+    unsigned long long total = 0;
+    for (size_t i = 0; i < faces; ++i)
+        total += odds_arr[i];
+    if (total == 0)
+        throw std::invalid_argument("Sum of odds must be positive!");
+    if (total > std::numeric_limits<Chance>::max())
+        throw std::invalid_argument("Sum of odds is too large!");
+
+    Vector<Chance> new_odds(faces, 0);
+    Vector<RandomWord> new_thresholds(faces - 1, 0);
+    unsigned long long prefix = 0;
+    fair = true;
+    last_face = 1;
+    for (size_t i = 0; i < faces; ++i)
+    {
+        new_odds[i] = odds_arr[i];
+        prefix += odds_arr[i];
+        if (i + 1 < faces)
+            new_thresholds[i] = static_cast<RandomWord>(std::min((prefix << 32) / total, 0xFFFFFFFFULL));
+        if (odds_arr[i] != 0)
+            last_face = static_cast<NumPoints>(i + 1);
+        fair = fair && odds_arr[i] == odds_arr[0];
+    }
+    odds = std::move(new_odds);
+    thresholds = std::move(new_thresholds);
+    if (value > faces)
+        to_change_value();
+}
+
+/*!
+    \brief Сеттер значения кости
+    \param[in] input_value значение кости.
+
+    \throw std::invalid_argument - если значение кости < 1 или > кол-ва граней.
+*/
+void RuntimeOneDice::set_value(const NumPoints input_value)
+{
+    if (input_value < 1 || input_value > get_faces())
+        throw std::invalid_argument("Invalid value!");
+    value = input_value;
+}
+
+/*!
+    \brief Геттер кол-ва граней
+    \return Кол-во граней кости.
+*/
+size_t RuntimeOneDice::get_faces() const noexcept
+{
+    return odds.get_size();
+}
+
+/*!
+    \brief Геттер значения кости
+    \return Текущее значение кости.
+*/
+NumPoints RuntimeOneDice::get_value() const noexcept
+{
+    return value;
+}
+
+/*!
+    \brief Геттер шанса грани
+    \param[in] index номер грани, начиная с 0.
+
+    \return Шанс выпадения грани index + 1.
+
+    \throw std::out_of_range - если index больше или равен кол-ву граней.
+*/
+Chance RuntimeOneDice::get_odds(const size_t index) const
+{
+    if (index >= get_faces())
+        throw std::out_of_range("Index out of range!");
+    return odds[index];
+}
+
+/*!
+    \brief Геттер ASCII-изображения значения кости
+    \return AsciiArt с текущим значением кости.
+*/
+AsciiArt RuntimeOneDice::get_value_AsciiArt() const
+{
+    return NumPoints_to_AsciiArt(value, get_faces());
+}
+
+/*!
+    \brief Бросок кости
+    \details Генерирует новое значение кости. "Честная" кость использует умножение и сдвиг, остальные - двоичный поиск
+   по порогам. Если источником случайных чисел выбрана энтропия, грань выбирается без смещения.
+
+    \return Новое значение кости.
+*/
+NumPoints RuntimeOneDice::to_change_value()
+{
+    size_t faces = get_faces();
+    if (get_random_source() == RandomSource::entropy)
+    {
+        Chance total = 0;
+        for (size_t i = 0; i < faces; ++i)
+            total += odds[i];
+        Chance random_num = random_below(total);
+        NumPoints face = 1;
+        for (Chance prefix = odds[0]; random_num >= prefix; ++face)
+            prefix += odds[face];
+        value = face;
+    }
+    else if (fair)
+        value = static_cast<NumPoints>(((static_cast<std::uint64_t>(random_word()) * faces) >> 32) + 1);
+    else
+        value = std::min(find_value(thresholds.get_data(), faces, random_word()), last_face);
+    journal_roll(journal_no_index, value, static_cast<NumPoints>(faces));
+    return value;
+}
+
+/*!
+    \brief Оператор ==
+    \details Сравнивает выпавшие значения двух костей.
+
+    \param[in] other ссылка на другую кость.
+
+    \return true - если выпавшее значение обоих объектов совпадает, иначе false.
+*/
+bool RuntimeOneDice::operator==(const RuntimeOneDice &other) const
+{
+    return value == other.value;
+}
+
+template bool check_NumPoints<4>(const NumPoints num);
+template NumPoints random_odds(const BasicOdds<4> &input_odds);
+template NumPoints random_odds<4>(const OddsHandle handle);
+template NumPoints random_odds_exact(const BasicOdds<4> &input_odds);
+template class BasicOneDice<4>;
+template std::istream &operator>>(std::istream &input, BasicOneDice<4> &dice);
+template std::ostream &operator<<(std::ostream &output, const BasicOneDice<4> &dice);
+
+template bool check_NumPoints<6>(const NumPoints num);
+template NumPoints random_odds(const BasicOdds<6> &input_odds);
+template NumPoints random_odds<6>(const OddsHandle handle);
+template NumPoints random_odds_exact(const BasicOdds<6> &input_odds);
+template class BasicOneDice<6>;
+template std::istream &operator>>(std::istream &input, BasicOneDice<6> &dice);
+template std::ostream &operator<<(std::ostream &output, const BasicOneDice<6> &dice);
+
+template bool check_NumPoints<8>(const NumPoints num);
+template NumPoints random_odds(const BasicOdds<8> &input_odds);
+template NumPoints random_odds<8>(const OddsHandle handle);
+template NumPoints random_odds_exact(const BasicOdds<8> &input_odds);
+template class BasicOneDice<8>;
+template std::istream &operator>>(std::istream &input, BasicOneDice<8> &dice);
+template std::ostream &operator<<(std::ostream &output, const BasicOneDice<8> &dice);
+
+template bool check_NumPoints<10>(const NumPoints num);
+template NumPoints random_odds(const BasicOdds<10> &input_odds);
+template NumPoints random_odds<10>(const OddsHandle handle);
+template NumPoints random_odds_exact(const BasicOdds<10> &input_odds);
+template class BasicOneDice<10>;
+template std::istream &operator>>(std::istream &input, BasicOneDice<10> &dice);
+template std::ostream &operator<<(std::ostream &output, const BasicOneDice<10> &dice);
+
+template bool check_NumPoints<12>(const NumPoints num);
+template NumPoints random_odds(const BasicOdds<12> &input_odds);
+template NumPoints random_odds<12>(const OddsHandle handle);
+template NumPoints random_odds_exact(const BasicOdds<12> &input_odds);
+template class BasicOneDice<12>;
+template std::istream &operator>>(std::istream &input, BasicOneDice<12> &dice);
+template std::ostream &operator<<(std::ostream &output, const BasicOneDice<12> &dice);
+
+template bool check_NumPoints<20>(const NumPoints num);
+template NumPoints random_odds(const BasicOdds<20> &input_odds);
+template NumPoints random_odds<20>(const OddsHandle handle);
+template NumPoints random_odds_exact(const BasicOdds<20> &input_odds);
+template class BasicOneDice<20>;
+template std::istream &operator>>(std::istream &input, BasicOneDice<20> &dice);
+template std::ostream &operator<<(std::ostream &output, const BasicOneDice<20> &dice);
+
+template bool check_NumPoints<100>(const NumPoints num);
+template NumPoints random_odds(const BasicOdds<100> &input_odds);
+template NumPoints random_odds<100>(const OddsHandle handle);
+template NumPoints random_odds_exact(const BasicOdds<100> &input_odds);
+template class BasicOneDice<100>;
+template std::istream &operator>>(std::istream &input, BasicOneDice<100> &dice);
+template std::ostream &operator<<(std::ostream &output, const BasicOneDice<100> &dice);
+
 /*! @} */
\ No newline at end of file
@@ -12,49 +12,96 @@
 
 #include "../../asciiArt/asciiArt.hpp"
 #include "./odds/odds.hpp"
+#include "./odds/registry/registry.hpp"
 
-typedef unsigned short int NumPoints; ///< Количество очков выпавшего значения
-
-bool check_NumPoints(const NumPoints num);
-NumPoints random_odds(const Odds &input_odds);
+template <size_t Faces = 6> bool check_NumPoints(const NumPoints num);
+template <size_t Faces> NumPoints random_odds(const BasicOdds<Faces> &input_odds);
+template <size_t Faces> NumPoints random_odds(const OddsHandle handle);
+template <size_t Faces> NumPoints random_odds_exact(const BasicOdds<Faces> &input_odds);
 
 /*!
-    \brief Класс для работы с одной игральной костью
-    \details Объект OneDice хранит выпавшее значение кости, вероятности выпадения каждого значения.
+    \brief Шаблон класса для работы с одной игральной костью
+    \details Объект BasicOneDice хранит выпавшее значение кости и номер вероятностей выпадения каждого из Faces
+    значений в реестре OddsRegistry. Шаблон инстанцирован для тех же кол-в граней, что и BasicOdds.
+
+    \tparam Faces кол-во граней кости.
 
-    \sa Odds, AsciiArt
+    \sa BasicOdds, OddsRegistry, AsciiArt
 */
-class OneDice
+template <size_t Faces> class BasicOneDice
 {
     private:
-        Odds odds;
+        OddsHandle odds = fair_odds_handle;
         NumPoints value = 0;
 
     public:
-        OneDice(const Odds &input_odds = Odds());
-        OneDice(const NumPoints input_value, const Odds &input_odds = Odds());
-        OneDice(const OneDice &other);
-        OneDice(OneDice &&other);
+        static constexpr size_t faces = Faces; ///< Кол-во граней кости
+
+        BasicOneDice();
+        BasicOneDice(const BasicOdds<Faces> &input_odds);
+        BasicOneDice(const NumPoints input_value);
+        BasicOneDice(const NumPoints input_value, const BasicOdds<Faces> &input_odds);
+        BasicOneDice(const BasicOneDice &other);
+        BasicOneDice(BasicOneDice &&other);
 
-        void set_odds(const Odds &input_odds);
+        void set_odds(const BasicOdds<Faces> &input_odds);
+        void set_odds_handle(const OddsHandle handle);
         void set_value(const NumPoints value);
 
         NumPoints get_value() const;
         AsciiArt get_value_AsciiArt() const;
-        Odds get_odds() const;
+        BasicOdds<Faces> get_odds() const;
+        OddsHandle get_odds_handle() const noexcept;
 
         NumPoints to_change_value();
 
-        bool operator==(const OneDice &other) const;
+        bool operator==(const BasicOneDice &other) const;
 
         void input(std::istream &input);
         void output(std::ostream &output) const;
 
-        OneDice &operator=(const OneDice &other);
-        OneDice &operator=(OneDice &&other);
+        BasicOneDice &operator=(const BasicOneDice &other);
+        BasicOneDice &operator=(BasicOneDice &&other);
+};
+
+template <size_t Faces> std::istream &operator>>(std::istream &input, BasicOneDice<Faces> &dice);
+template <size_t Faces> std::ostream &operator<<(std::ostream &output, const BasicOneDice<Faces> &dice);
+
+typedef BasicOneDice<6> OneDice; ///< Шестигранная игральная кость
+
+/*!
+    \brief Класс игральной кости с кол-вом граней, заданным во время выполнения
+    \details Объект RuntimeOneDice хранит выпавшее значение, шансы выпадения каждой из faces граней и пороги случайного
+    числа для выбора грани. Используется, когда кол-во граней неизвестно на этапе компиляции или для него не
+    инстанцирован BasicOneDice. Грань ищется двоичным поиском по порогам.
+
+    \sa BasicOneDice
+*/
+class RuntimeOneDice
+{
+    private:
+        Vector<Chance> odds;
+        Vector<RandomWord> thresholds;
+        NumPoints last_face = 1;
+        bool fair = true;
+        NumPoints value = 0;
+
+    public:
+        RuntimeOneDice(const size_t faces);
+        RuntimeOneDice(const Chance *odds_arr, const size_t faces);
+        RuntimeOneDice(const NumPoints input_value, const size_t faces);
+
+        void set_odds(const Chance *odds_arr, const size_t faces);
+        void set_value(const NumPoints input_value);
+
+        size_t get_faces() const noexcept;
+        NumPoints get_value() const noexcept;
+        Chance get_odds(const size_t index) const;
+        AsciiArt get_value_AsciiArt() const;
+
+        NumPoints to_change_value();
 
-        friend std::istream &operator>>(std::istream &input, OneDice &dice);
-        friend std::ostream &operator<<(std::ostream &output, const OneDice &dice);
+        bool operator==(const RuntimeOneDice &other) const;
 };
 
 /*! @} */
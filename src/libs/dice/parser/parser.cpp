@@ -0,0 +1,294 @@
+#include "parser.hpp"
+
+/*!
+    \addtogroup Parser_submodule
+    @{
+*/
+
+#include <charconv>
+
+#include "../mapped/mapped.hpp"
+
+/*!
+    \brief Конструктор ошибки
+    \details Создаёт ошибку разбора с сообщением message в байте offset. Смещение добавляется в текст сообщения.
+
+    \param[in] message ссылка на сообщение.
+    \param[in] offset смещение ошибки в байтах.
+*/
+ParseError::ParseError(const std::string &message, const size_t offset)
+    : std::invalid_argument(message + " (offset " + std::to_string(offset) + ")"), offset(offset)
+{
+}
+
+/*!
+    \brief Геттер смещения
+    \details Возвращает смещение места ошибки в байтах от начала текста.
+
+    \return Смещение ошибки.
+*/
+size_t ParseError::get_offset() const noexcept
+{
+    return offset;
+}
+
+/*!
+    \brief Конструктор с диапазоном
+    \details Создаёт объект разбора текста first..last.
+
+    \param[in] first указатель на начало текста.
+    \param[in] last указатель на конец текста.
+*/
+TextParser::TextParser(const char *first, const char *last) noexcept : first(first), current(first), last(last)
+{
+}
+
+/*!
+    \brief Конструктор со строкой
+    \details Создаёт объект разбора строки text. Строка должна существовать, пока идёт разбор.
+
+    \param[in] text ссылка на строку.
+*/
+TextParser::TextParser(const std::string &text) noexcept : TextParser(text.data(), text.data() + text.size())
+{
+}
+
+/*!
+    \brief Пропуск пробельных символов
+    \details Сдвигает позицию разбора на первый непробельный символ.
+*/
+void TextParser::skip_spaces() noexcept
+{
+    while (current != last && (*current == ' ' || *current == '\n' || *current == '\t' || *current == '\r'))
+        ++current;
+}
+
+/*!
+    \brief Геттер смещения
+    \details Возвращает смещение текущей позиции разбора в байтах от начала текста.
+
+    \return Смещение текущей позиции.
+*/
+size_t TextParser::get_offset() const noexcept
+{
+    return static_cast<size_t>(current - first);
+}
+
+/*!
+    \brief Геттер остатка
+    \details Возвращает кол-во неразобранных байт.
+
+    \return Кол-во неразобранных байт.
+*/
+size_t TextParser::get_remaining() const noexcept
+{
+    return static_cast<size_t>(last - current);
+}
+
+/*!
+    \brief Проверка конца текста
+    \details Пропускает пробельные символы и проверяет, разобран ли весь текст.
+
+    \return True если текст разобран. Иначе False.
+*/
+bool TextParser::is_end() noexcept
+{
+    skip_spaces();
+    return current == last;
+}
+
+/*!
+    \brief Разбор цифры
+    \details Пропускает пробельные символы и, если в текущей позиции записано однозначное число, читает его. Быстрый
+   путь для значений костей, не вызывающий std::from_chars.
+
+    \return Прочитанную цифру или -1, если в текущей позиции не однозначное число. В этом случае позиция остаётся
+   на начале числа.
+*/
+int TextParser::parse_digit() noexcept
+{
+    skip_spaces();
+    if (last - current < 1 || *current < '0' || *current > '9')
+        return -1;
+    if (last - current > 1 && current[1] != ' ' && current[1] != '\n' && current[1] != '\t' && current[1] != '\r')
+        return -1;
+    return *current++ - '0';
+}
+
+/*!
+    \brief Разбор числа
+    \details Пропускает пробельные символы и читает неотрицательное целое число. После числа должен идти пробельный
+   символ или конец текста.
+
+    \tparam T тип числа.
+
+    \return Прочитанное число.
+
+    \throw ParseError - если в текущей позиции нет числа или число не помещается в T.
+*/
+template <typename T> T TextParser::parse_number()
+{
+    skip_spaces();
+    T value = 0;
+    std::from_chars_result result = std::from_chars(current, last, value);
+    if (result.ec == std::errc::result_out_of_range)
+        throw ParseError("Number is too large!", get_offset());
+    if (result.ec != std::errc() ||
+        (result.ptr != last && *result.ptr != ' ' && *result.ptr != '\n' && *result.ptr != '\t' && *result.ptr != '\r'))
+        throw ParseError("Invalid number!", get_offset());
+    current = result.ptr;
+    return value;
+}
+
+/*!
+    \brief Разбор шансов
+    \details Читает Faces шансов выпадения граней в формате оператора >>.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in,out] parser ссылка на объект разбора текста.
+
+    \return Шансы выпадения граней.
+
+    \throw ParseError - если шансы записаны неверно или их сумма равна 0 или слишком велика.
+*/
+template <size_t Faces> BasicOdds<Faces> parse_Odds(TextParser &parser)
+{
+    Chance odds[Faces];
+    size_t offset = parser.get_offset();
+    for (size_t i = 0; i < Faces; ++i)
+        odds[i] = parser.parse_number<Chance>();
+    try
+    {
+        return BasicOdds<Faces>(odds);
+    }
+    catch (const std::invalid_argument &)
+    {
+        throw ParseError("Invalid odds!", offset);
+    }
+}
+
+/*!
+    \brief Разбор кости
+    \details Читает значение и шансы выпадения граней кости в формате метода input.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in,out] parser ссылка на объект разбора текста.
+
+    \return Кость.
+
+    \throw ParseError - если кость записана неверно.
+*/
+template <size_t Faces> BasicOneDice<Faces> parse_OneDice(TextParser &parser)
+{
+    parser.is_end();
+    size_t offset = parser.get_offset();
+    NumPoints value = parser.parse_number<NumPoints>();
+    if (!check_NumPoints<Faces>(value))
+        throw ParseError("Invalid value!", offset);
+    return BasicOneDice<Faces>(value, parse_Odds<Faces>(parser));
+}
+
+/*!
+    \brief Разбор группы костей
+    \details Читает кол-во костей и их значения в формате оператора >>. Память под значения выделяется сразу по
+   кол-ву костей, значения записываются без промежуточных объектов. Однозначные значения читаются без
+   std::from_chars.
+
+    \param[in,out] parser ссылка на объект разбора текста.
+
+    \return Группа "честных" костей.
+
+    \throw ParseError - если кол-во или значение кости записано неверно или значений меньше, чем указано.
+*/
+Dice parse_Dice(TextParser &parser)
+{
+    parser.is_end();
+    size_t count_offset = parser.get_offset();
+    size_t count = parser.parse_number<size_t>();
+    if (count > (parser.get_remaining() + 1) / 2)
+        throw ParseError("Not enough values!", count_offset);
+    Vector<PackedNumPoints> values(count);
+    PackedNumPoints *value = values.get_data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        int digit = parser.parse_digit();
+        if (digit > 0 && static_cast<size_t>(digit) <= OneDice::faces)
+        {
+            value[i] = static_cast<PackedNumPoints>(digit);
+            continue;
+        }
+        if (digit >= 0)
+            throw ParseError("Invalid value!", parser.get_offset() - 1);
+        if (parser.is_end())
+            throw ParseError("Not enough values!", parser.get_offset());
+        size_t offset = parser.get_offset();
+        NumPoints number = parser.parse_number<NumPoints>();
+        if (!check_NumPoints(number))
+            throw ParseError("Invalid value!", offset);
+        value[i] = static_cast<PackedNumPoints>(number);
+    }
+    Dice dice;
+    dice.load_values(std::move(values));
+    return dice;
+}
+
+/*!
+    \brief Разбор группы костей
+    \details Читает группу костей из текста first..last. После группы в тексте могут быть только пробельные символы.
+
+    \param[in] first указатель на начало текста.
+    \param[in] last указатель на конец текста.
+
+    \return Группа "честных" костей.
+
+    \throw ParseError - если группа записана неверно или после неё есть лишний текст.
+*/
+Dice parse_Dice(const char *first, const char *last)
+{
+    TextParser parser(first, last);
+    Dice dice = parse_Dice(parser);
+    if (!parser.is_end())
+        throw ParseError("Unexpected text!", parser.get_offset());
+    return dice;
+}
+
+/*!
+    \brief Загрузка группы костей
+    \details Отображает текстовый файл path в память с загрузкой всех страниц и читает из него группу костей.
+
+    \param[in] path ссылка на путь к файлу.
+
+    \return Группа "честных" костей.
+
+    \throw std::system_error - если файл не удалось открыть.
+    \throw ParseError - если группа записана неверно.
+*/
+Dice load_Dice(const std::string &path)
+{
+    MappedFile file(path, true);
+    return parse_Dice(file.get_data(), file.get_data() + file.get_size());
+}
+
+template NumPoints TextParser::parse_number<NumPoints>();
+template Chance TextParser::parse_number<Chance>();
+template size_t TextParser::parse_number<size_t>();
+
+template BasicOdds<4> parse_Odds(TextParser &parser);
+template BasicOdds<6> parse_Odds(TextParser &parser);
+template BasicOdds<8> parse_Odds(TextParser &parser);
+template BasicOdds<10> parse_Odds(TextParser &parser);
+template BasicOdds<12> parse_Odds(TextParser &parser);
+template BasicOdds<20> parse_Odds(TextParser &parser);
+template BasicOdds<100> parse_Odds(TextParser &parser);
+
+template BasicOneDice<4> parse_OneDice(TextParser &parser);
+template BasicOneDice<6> parse_OneDice(TextParser &parser);
+template BasicOneDice<8> parse_OneDice(TextParser &parser);
+template BasicOneDice<10> parse_OneDice(TextParser &parser);
+template BasicOneDice<12> parse_OneDice(TextParser &parser);
+template BasicOneDice<20> parse_OneDice(TextParser &parser);
+template BasicOneDice<100> parse_OneDice(TextParser &parser);
+
+/*! @} */
@@ -0,0 +1,69 @@
+/*!
+    \defgroup Parser_submodule Разбор текста
+    \ingroup Dice_module
+    \brief Быстрый разбор костей из текста в памяти или в файле
+*/
+#ifndef PARSER_HPP
+#define PARSER_HPP
+
+/*!
+    \addtogroup Parser_submodule
+    @{
+*/
+
+#include <stdexcept>
+#include <string>
+
+#include "../dice.hpp"
+
+/*!
+    \brief Ошибка разбора
+    \details Исключение ParseError хранит смещение в байтах от начала текста до места ошибки.
+*/
+class ParseError : public std::invalid_argument
+{
+    private:
+        size_t offset;
+
+    public:
+        ParseError(const std::string &message, const size_t offset);
+
+        size_t get_offset() const noexcept;
+};
+
+/*!
+    \brief Класс разбора текста
+    \details Объект TextParser читает числа, разделённые пробельными символами, из текста first..last через
+   std::from_chars без копирования текста.
+*/
+class TextParser
+{
+    private:
+        const char *first;
+        const char *current;
+        const char *last;
+
+        void skip_spaces() noexcept;
+
+    public:
+        TextParser(const char *first, const char *last) noexcept;
+        TextParser(const std::string &text) noexcept;
+
+        size_t get_offset() const noexcept;
+        size_t get_remaining() const noexcept;
+        bool is_end() noexcept;
+
+        int parse_digit() noexcept;
+
+        template <typename T> T parse_number();
+};
+
+template <size_t Faces> BasicOdds<Faces> parse_Odds(TextParser &parser);
+template <size_t Faces> BasicOneDice<Faces> parse_OneDice(TextParser &parser);
+Dice parse_Dice(TextParser &parser);
+Dice parse_Dice(const char *first, const char *last);
+Dice load_Dice(const std::string &path);
+
+/*! @} */
+
+#endif // PARSER_HPP
@@ -0,0 +1,146 @@
+#include "philox.hpp"
+
+/*!
+    \addtogroup Philox_submodule
+    @{
+*/
+
+constexpr std::uint32_t philox_m0 = 0xD2511F53u; ///< Множитель первой пары слов
+constexpr std::uint32_t philox_m1 = 0xCD9E8D57u; ///< Множитель второй пары слов
+constexpr std::uint32_t philox_w0 = 0x9E3779B9u; ///< Приращение первой половины ключа
+constexpr std::uint32_t philox_w1 = 0xBB67AE85u; ///< Приращение второй половины ключа
+constexpr size_t philox_rounds = 10;             ///< Кол-во раундов
+
+/*!
+    \brief Генератор Philox4x32-10
+    \details Вычисляет 4 случайных числа по 128-битному счётчику и 64-битному ключу.
+
+    \param[in] counter указатель на 4 слова счётчика.
+    \param[in] key указатель на 2 слова ключа.
+    \param[out] words указатель на массив для 4 случайных чисел.
+*/
+void philox4x32(const std::uint32_t *counter, const std::uint32_t *key, RandomWord *words) noexcept
+{
+    std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    std::uint32_t k0 = key[0], k1 = key[1];
+    for (size_t round = 0; round < philox_rounds; ++round)
+    {
+        std::uint64_t product0 = static_cast<std::uint64_t>(philox_m0) * c0;
+        std::uint64_t product1 = static_cast<std::uint64_t>(philox_m1) * c2;
+        c0 = static_cast<std::uint32_t>(product1 >> 32) ^ c1 ^ k0;
+        c2 = static_cast<std::uint32_t>(product0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<std::uint32_t>(product1);
+        c3 = static_cast<std::uint32_t>(product0);
+        k0 += philox_w0;
+        k1 += philox_w1;
+    }
+    words[0] = c0;
+    words[1] = c1;
+    words[2] = c2;
+    words[3] = c3;
+}
+
+/*!
+    \brief Стандартный конструктор
+    \details Создаёт генератор с нулевым зерном и номером группы.
+*/
+CounterEngine::CounterEngine() noexcept
+{
+}
+
+/*!
+    \brief Конструктор с зерном
+    \details Создаёт генератор с зерном seed для группы костей с номером group.
+
+    \param[in] seed зерно.
+    \param[in] group номер группы костей.
+*/
+CounterEngine::CounterEngine(const std::uint64_t seed, const std::uint32_t group) noexcept : seed(seed), group(group)
+{
+}
+
+/*!
+    \brief Геттер зерна
+    \details Возвращает зерно генератора.
+
+    \return Зерно генератора.
+*/
+std::uint64_t CounterEngine::get_seed() const noexcept
+{
+    return seed;
+}
+
+/*!
+    \brief Геттер номера группы
+    \details Возвращает номер группы костей генератора.
+
+    \return Номер группы костей.
+*/
+std::uint32_t CounterEngine::get_group() const noexcept
+{
+    return group;
+}
+
+/*!
+    \brief Случайное число кости
+    \details Вычисляет случайное число кости с номером index в броске с номером epoch. Четыре соседние кости получают
+   числа из одного значения счётчика.
+
+    \param[in] index номер кости.
+    \param[in] epoch номер броска.
+
+    \return Случайное число.
+*/
+RandomWord CounterEngine::get_word(const std::uint64_t index, const std::uint32_t epoch) const noexcept
+{
+    RandomWord words[philox_words];
+    std::uint64_t block = index / philox_words;
+    std::uint32_t counter[4] = {static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32), epoch,
+                                group};
+    std::uint32_t key[2] = {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+    philox4x32(counter, key, words);
+    return words[index % philox_words];
+}
+
+/*!
+    \brief Случайные числа костей
+    \details Вычисляет случайные числа костей с номерами first..first + count - 1 в броске с номером epoch. Результат
+   совпадает с get_word для каждой кости.
+
+    \param[in] first номер первой кости.
+    \param[in] epoch номер броска.
+    \param[out] words указатель на массив для случайных чисел.
+    \param[in] count кол-во костей.
+*/
+void CounterEngine::fill(const std::uint64_t first, const std::uint32_t epoch, RandomWord *words,
+                         const size_t count) const noexcept
+{
+    std::uint32_t key[2] = {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+    std::uint64_t index = first;
+    const std::uint64_t last = first + count;
+    while (index < last)
+    {
+        RandomWord block_words[philox_words];
+        std::uint64_t block = index / philox_words;
+        std::uint32_t counter[4] = {static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32), epoch,
+                                    group};
+        philox4x32(counter, key, block_words);
+        for (size_t lane = index % philox_words; lane < philox_words && index < last; ++lane, ++index)
+            *words++ = block_words[lane];
+    }
+}
+
+/*!
+    \brief Оператор ==
+    \details Перегрузка оператора == для сравнения двух генераторов.
+
+    \param[in] other ссылка на другой генератор.
+
+    \return True если зерно и номер группы совпадают. Иначе False.
+*/
+bool CounterEngine::operator==(const CounterEngine &other) const noexcept
+{
+    return seed == other.seed && group == other.group;
+}
+
+/*! @} */
@@ -0,0 +1,47 @@
+/*!
+    \defgroup Philox_submodule Генератор на счётчике
+    \ingroup Random_submodule
+    \brief Генератор Philox4x32-10, вычисляющий любое число последовательности за O(1)
+*/
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+/*!
+    \addtogroup Philox_submodule
+    @{
+*/
+
+#include "../random.hpp"
+
+constexpr size_t philox_words = 4; ///< Кол-во чисел, получаемых из одного значения счётчика
+
+void philox4x32(const std::uint32_t *counter, const std::uint32_t *key, RandomWord *words) noexcept;
+
+/*!
+    \brief Генератор на счётчике
+    \details Объект CounterEngine вычисляет случайное число по зерну, номеру группы костей, номеру кости и номеру
+    броска (эпохе) без хранения состояния, поэтому любой бросок можно повторить независимо от остальных.
+*/
+class CounterEngine
+{
+    private:
+        std::uint64_t seed = 0;
+        std::uint32_t group = 0;
+
+    public:
+        CounterEngine() noexcept;
+        CounterEngine(const std::uint64_t seed, const std::uint32_t group = 0) noexcept;
+
+        std::uint64_t get_seed() const noexcept;
+        std::uint32_t get_group() const noexcept;
+
+        RandomWord get_word(const std::uint64_t index, const std::uint32_t epoch) const noexcept;
+        void fill(const std::uint64_t first, const std::uint32_t epoch, RandomWord *words,
+                  const size_t count) const noexcept;
+
+        bool operator==(const CounterEngine &other) const noexcept;
+};
+
+/*! @} */
+
+#endif // PHILOX_HPP
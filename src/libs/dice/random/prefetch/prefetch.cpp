@@ -0,0 +1,174 @@
+#include "prefetch.hpp"
+
+/*!
+    \addtogroup Prefetch_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+constexpr size_t prefetch_block = 256; ///< Кол-во чисел, генерируемых фоновым потоком за один раз
+constexpr std::chrono::microseconds prefetch_pause(50); ///< Пауза фонового потока при заполненном буфере
+
+/*!
+    \brief Конструктор
+    \details Создаёт пустой кольцевой буфер.
+
+    \param[in] capacity ёмкость буфера.
+
+    \throw std::invalid_argument - если capacity не является степенью двойки.
+*/
+RandomRing::RandomRing(const size_t capacity) : head(0), tail(0)
+{
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        throw std::invalid_argument("Ring capacity must be a power of two!");
+    data = new RandomWord[capacity];
+    mask = capacity - 1;
+}
+
+/*!
+    \brief Деструктор
+    \details Освобождает память буфера.
+*/
+RandomRing::~RandomRing() noexcept
+{
+    delete[] data;
+}
+
+/*!
+    \brief Геттер ёмкости
+    \details Возвращает ёмкость буфера.
+
+    \return Ёмкость буфера.
+*/
+size_t RandomRing::get_capacity() const noexcept
+{
+    return mask + 1;
+}
+
+/*!
+    \brief Запись в буфер
+    \details Записывает в буфер столько чисел из words, сколько в нём свободного места. Вызывается только писателем.
+
+    \param[in] words указатель на массив чисел.
+    \param[in] count кол-во чисел.
+
+    \return Кол-во записанных чисел.
+*/
+size_t RandomRing::push(const RandomWord *words, const size_t count) noexcept
+{
+    size_t current_tail = tail.load(std::memory_order_relaxed);
+    if (current_tail - cached_head + count > get_capacity())
+        cached_head = head.load(std::memory_order_acquire);
+    size_t written = std::min(count, get_capacity() - (current_tail - cached_head));
+    for (size_t i = 0; i < written; ++i)
+        data[(current_tail + i) & mask] = words[i];
+    tail.store(current_tail + written, std::memory_order_release);
+    return written;
+}
+
+/*!
+    \brief Чтение из буфера
+    \details Извлекает из буфера одно число. Вызывается только читателем.
+
+    \param[out] word ссылка на извлечённое число.
+
+    \return True если буфер не был пуст. Иначе False.
+*/
+bool RandomRing::pop(RandomWord &word) noexcept
+{
+    size_t current_head = head.load(std::memory_order_relaxed);
+    if (current_head == cached_tail)
+    {
+        cached_tail = tail.load(std::memory_order_acquire);
+        if (current_head == cached_tail)
+            return false;
+    }
+    word = data[current_head & mask];
+    head.store(current_head + 1, std::memory_order_release);
+    return true;
+}
+
+/*!
+    \brief Конструктор
+    \details Создаёт кольцевой буфер и запускает поток, заполняющий его.
+
+    \param[in] capacity ёмкость буфера.
+
+    \throw std::invalid_argument - если capacity не является степенью двойки.
+*/
+RandomPrefetch::RandomPrefetch(const size_t capacity)
+    : ring(capacity), stopped(false), produced(0), consumed(0), underruns(0)
+{
+    producer = std::thread(&RandomPrefetch::produce, this);
+}
+
+/*!
+    \brief Деструктор
+    \details Останавливает фоновый поток и дожидается его завершения.
+*/
+RandomPrefetch::~RandomPrefetch() noexcept
+{
+    stopped.store(true, std::memory_order_relaxed);
+    producer.join();
+}
+
+/*!
+    \brief Работа фонового потока
+    \details Пакетно генерирует случайные числа и записывает их в буфер. Если буфер заполнен, поток ждёт
+   prefetch_pause.
+*/
+void RandomPrefetch::produce()
+{
+    RandomWord block[prefetch_block];
+    while (!stopped.load(std::memory_order_relaxed))
+    {
+        fill_random(block, prefetch_block);
+        size_t written = 0;
+        while (written < prefetch_block && !stopped.load(std::memory_order_relaxed))
+        {
+            written += ring.push(block + written, prefetch_block - written);
+            if (written < prefetch_block)
+                std::this_thread::sleep_for(prefetch_pause);
+        }
+        produced.fetch_add(written, std::memory_order_relaxed);
+    }
+}
+
+/*!
+    \brief Следующее число
+    \details Извлекает следующее число из буфера. Если буфер пуст, увеличивает счётчик опустошений.
+
+    \param[out] word ссылка на извлечённое число.
+
+    \return True если буфер не был пуст. Иначе False.
+*/
+bool RandomPrefetch::next(RandomWord &word) noexcept
+{
+    if (ring.pop(word))
+    {
+        consumed.store(consumed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+    underruns.store(underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return false;
+}
+
+/*!
+    \brief Геттер счётчиков
+    \details Возвращает текущие значения счётчиков фоновой генерации.
+
+    \return Счётчики фоновой генерации.
+*/
+RandomPrefetchStats RandomPrefetch::get_stats() const noexcept
+{
+    RandomPrefetchStats stats;
+    stats.produced = produced.load(std::memory_order_relaxed);
+    stats.consumed = consumed.load(std::memory_order_relaxed);
+    stats.underruns = underruns.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/*! @} */
@@ -0,0 +1,76 @@
+/*!
+    \defgroup Prefetch_submodule Фоновая генерация случайных чисел
+    \ingroup Random_submodule
+    \brief Кольцевой буфер случайных чисел, заполняемый фоновым потоком
+*/
+#ifndef RANDOM_PREFETCH_HPP
+#define RANDOM_PREFETCH_HPP
+
+/*!
+    \addtogroup Prefetch_submodule
+    @{
+*/
+
+#include <atomic>
+#include <thread>
+
+#include "../random.hpp"
+
+/*!
+    \brief Кольцевой буфер случайных чисел
+    \details Очередь без блокировок для одного писателя и одного читателя. Ёмкость - степень двойки.
+*/
+class RandomRing
+{
+    private:
+        RandomWord *data = nullptr;
+        size_t mask = 0;
+        alignas(64) std::atomic<size_t> head;
+        size_t cached_tail = 0;
+        alignas(64) std::atomic<size_t> tail;
+        size_t cached_head = 0;
+
+    public:
+        RandomRing(const size_t capacity);
+        RandomRing(const RandomRing &other) = delete;
+        ~RandomRing() noexcept;
+
+        size_t get_capacity() const noexcept;
+
+        size_t push(const RandomWord *words, const size_t count) noexcept;
+        bool pop(RandomWord &word) noexcept;
+
+        RandomRing &operator=(const RandomRing &other) = delete;
+};
+
+/*!
+    \brief Фоновая генерация случайных чисел
+    \details Объект RandomPrefetch владеет кольцевым буфером и потоком, который заполняет его пакетно сгенерированными
+    случайными числами. Читать из буфера может только один поток.
+*/
+class RandomPrefetch
+{
+    private:
+        RandomRing ring;
+        std::atomic<bool> stopped;
+        std::atomic<std::uint64_t> produced;
+        std::atomic<std::uint64_t> consumed;
+        std::atomic<std::uint64_t> underruns;
+        std::thread producer;
+
+        void produce();
+
+    public:
+        RandomPrefetch(const size_t capacity);
+        RandomPrefetch(const RandomPrefetch &other) = delete;
+        ~RandomPrefetch() noexcept;
+
+        bool next(RandomWord &word) noexcept;
+        RandomPrefetchStats get_stats() const noexcept;
+
+        RandomPrefetch &operator=(const RandomPrefetch &other) = delete;
+};
+
+/*! @} */
+
+#endif // RANDOM_PREFETCH_HPP
@@ -0,0 +1,500 @@
+#include "random.hpp"
+
+/*!
+    \addtogroup Random_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/random.h>
+#else
+#include <random>
+#endif
+
+#include "./prefetch/prefetch.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RANDOM_X86
+#endif
+
+constexpr size_t random_lanes = 4; ///< Кол-во независимых генераторов для пакетной генерации
+
+/*!
+    \brief Состояние генератора xorshift128+
+    \details Каждый поток хранит своё состояние генератора для одиночных чисел и random_lanes состояний для пакетной
+    генерации.
+*/
+struct RandomState
+{
+        std::uint64_t s0;
+        std::uint64_t s1;
+        alignas(32) std::uint64_t lanes_s0[random_lanes];
+        alignas(32) std::uint64_t lanes_s1[random_lanes];
+};
+
+static std::atomic<std::uint64_t> global_seed(0x853C49E6748FEA9BULL); ///< Зерно для новых потоков
+static std::atomic<std::uint64_t> stream_counter(0);                  ///< Номер следующего потока
+static std::atomic<int> forced_SimdLevel(-1);                         ///< Принудительный набор инструкций
+
+/*!
+    \brief Буфер энтропии
+    \details Хранит entropy_buffer_words чисел, прочитанных из энтропии операционной системы, и позицию следующего
+    непрочитанного числа.
+*/
+struct EntropyBuffer
+{
+        RandomWord words[entropy_buffer_words];
+        size_t position = entropy_buffer_words;
+};
+
+thread_local std::unique_ptr<RandomPrefetch> thread_prefetch; ///< Фоновая генерация текущего потока
+thread_local std::unique_ptr<EntropyBuffer> thread_entropy;   ///< Буфер энтропии текущего потока
+
+/*!
+    \brief Шаг генератора splitmix64
+    \details Используется для получения начального состояния xorshift128+ из зерна.
+
+    \param[in,out] x ссылка на состояние splitmix64.
+
+    \return Следующее 64-битное число.
+*/
+std::uint64_t splitmix64(std::uint64_t &x)
+{
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/*!
+    \brief Инициализация состояния
+    \details Вычисляет состояние генератора по зерну и номеру потока.
+
+    \param[out] state ссылка на состояние генератора.
+    \param[in] seed зерно.
+    \param[in] stream номер потока.
+*/
+void init_state(RandomState &state, const std::uint64_t seed, const std::uint64_t stream)
+{
+    std::uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    state.s0 = splitmix64(x);
+    state.s1 = splitmix64(x);
+    if (state.s0 == 0 && state.s1 == 0)
+        state.s1 = 1;
+    for (size_t i = 0; i < random_lanes; ++i)
+    {
+        state.lanes_s0[i] = splitmix64(x);
+        state.lanes_s1[i] = splitmix64(x);
+        if (state.lanes_s0[i] == 0 && state.lanes_s1[i] == 0)
+            state.lanes_s1[i] = 1;
+    }
+}
+
+/*!
+    \brief Состояние генератора текущего потока
+    \details При первом обращении состояние вычисляется из текущего зерна и порядкового номера потока.
+
+    \return Ссылка на состояние генератора текущего потока.
+*/
+RandomState &thread_state()
+{
+    thread_local RandomState state = []
+    {
+        RandomState result;
+        init_state(result, global_seed.load(std::memory_order_relaxed),
+                   stream_counter.fetch_add(1, std::memory_order_relaxed));
+        return result;
+    }();
+    return state;
+}
+
+/*!
+    \brief Установка зерна
+    \details Устанавливает зерно генератора. Состояние текущего потока вычисляется заново, потоки, которые ещё не
+   обращались к генератору, получат состояния, зависящие от нового зерна.
+
+    \param[in] seed зерно.
+*/
+void seed_random(const std::uint64_t seed)
+{
+    RandomState &state = thread_state();
+    global_seed.store(seed, std::memory_order_relaxed);
+    stream_counter.store(1, std::memory_order_relaxed);
+    init_state(state, seed, 0);
+}
+
+/*!
+    \brief Заполнение буфера энтропии
+    \details Заполняет буфер энтропией операционной системы. В Linux буфер заполняется одним вызовом getrandom
+   (повторным только при прерывании сигналом), на других системах используется std::random_device.
+
+    \param[out] buffer ссылка на буфер энтропии.
+
+    \throw std::system_error - если операционная система не смогла выдать энтропию.
+*/
+void refill_entropy(EntropyBuffer &buffer)
+{
+#if defined(__linux__)
+    char *bytes = reinterpret_cast<char *>(buffer.words);
+    size_t size = sizeof(buffer.words);
+    while (size > 0)
+    {
+        ssize_t result = getrandom(bytes, size, 0);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "getrandom");
+        }
+        bytes += result;
+        size -= static_cast<size_t>(result);
+    }
+#else
+    static thread_local std::random_device device;
+    for (RandomWord &word : buffer.words)
+        word = static_cast<RandomWord>(device());
+#endif
+    buffer.position = 0;
+}
+
+/*!
+    \brief Чтение из буфера энтропии
+    \details Копирует count чисел из буфера энтропии текущего потока, заполняя его заново по мере опустошения.
+
+    \param[out] words указатель на массив для случайных чисел.
+    \param[in] count кол-во случайных чисел.
+
+    \throw std::system_error - если операционная система не смогла выдать энтропию.
+*/
+void read_entropy(RandomWord *words, size_t count)
+{
+    EntropyBuffer &buffer = *thread_entropy;
+    while (count > 0)
+    {
+        if (buffer.position == entropy_buffer_words)
+            refill_entropy(buffer);
+        size_t block = std::min(count, entropy_buffer_words - buffer.position);
+        std::copy(buffer.words + buffer.position, buffer.words + buffer.position + block, words);
+        buffer.position += block;
+        words += block;
+        count -= block;
+    }
+}
+
+/*!
+    \brief Сеттер источника случайных чисел
+    \details Выбирает источник случайных чисел для текущего потока. Буфер энтропии создаётся при первом выборе
+   RandomSource::entropy и освобождается при возврате к генератору.
+
+    \param[in] source источник случайных чисел.
+*/
+void set_random_source(const RandomSource source)
+{
+    if (source == RandomSource::entropy && !thread_entropy)
+        thread_entropy.reset(new EntropyBuffer());
+    else if (source == RandomSource::xorshift)
+        thread_entropy.reset();
+}
+
+/*!
+    \brief Геттер источника случайных чисел
+    \details Возвращает источник случайных чисел текущего потока.
+
+    \return Источник случайных чисел.
+*/
+RandomSource get_random_source() noexcept
+{
+    return thread_entropy ? RandomSource::entropy : RandomSource::xorshift;
+}
+
+/*!
+    \brief Случайное число
+    \details Если источником текущего потока выбрана энтропия, возвращает следующее число из буфера энтропии.
+   Иначе возвращает следующее число из буфера фоновой генерации, если она включена для текущего потока и буфер не
+   пуст. Иначе возвращает следующее число генератора xorshift128+ текущего потока (старшие 32 бита результата).
+
+    \return Равномерно распределённое случайное 32-битное число.
+*/
+RandomWord random_word()
+{
+    RandomWord word;
+    if (thread_entropy)
+    {
+        read_entropy(&word, 1);
+        return word;
+    }
+    if (thread_prefetch && thread_prefetch->next(word))
+        return word;
+    RandomState &state = thread_state();
+    std::uint64_t s1 = state.s0;
+    const std::uint64_t s0 = state.s1;
+    state.s0 = s0;
+    s1 ^= s1 << 23;
+    state.s1 = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+    return static_cast<RandomWord>((state.s1 + s0) >> 32);
+}
+
+/*!
+    \brief Случайное число в диапазоне
+    \details Возвращает равномерно распределённое число из [0, bound) без смещения: число получается умножением и
+   сдвигом, а значения, дающие смещение, отбрасываются (метод Лемира).
+
+    \param[in] bound верхняя граница диапазона, не включая её.
+
+    \return Случайное число из [0, bound).
+
+    \throw std::invalid_argument - если bound == 0.
+*/
+RandomWord random_below(const RandomWord bound)
+{
+    if (bound == 0)
+        throw std::invalid_argument("Bound must be positive!");
+    std::uint64_t product = static_cast<std::uint64_t>(random_word()) * bound;
+    RandomWord low = static_cast<RandomWord>(product);
+    if (low < bound)
+    {
+        RandomWord rejected = static_cast<RandomWord>(-bound) % bound;
+        while (low < rejected)
+        {
+            product = static_cast<std::uint64_t>(random_word()) * bound;
+            low = static_cast<RandomWord>(product);
+        }
+    }
+    return static_cast<RandomWord>(product >> 32);
+}
+
+/*!
+    \brief Включение фоновой генерации
+    \details Создаёт для текущего потока кольцевой буфер и фоновый поток, который заполняет его случайными числами.
+   После этого random_word читает числа из буфера, а при пустом буфере генерирует их сам. Числа фонового потока
+   зависят от порядка запуска потоков, поэтому броски не воспроизводятся по зерну. Повторный вызов пересоздаёт буфер.
+
+    \param[in] capacity ёмкость буфера, степень двойки.
+
+    \throw std::invalid_argument - если capacity не является степенью двойки.
+*/
+void start_random_prefetch(const size_t capacity)
+{
+    thread_prefetch.reset();
+    thread_prefetch.reset(new RandomPrefetch(capacity));
+}
+
+/*!
+    \brief Выключение фоновой генерации
+    \details Останавливает фоновый поток текущего потока и освобождает буфер.
+*/
+void stop_random_prefetch() noexcept
+{
+    thread_prefetch.reset();
+}
+
+/*!
+    \brief Геттер счётчиков фоновой генерации
+    \details Возвращает счётчики фоновой генерации текущего потока.
+
+    \return Счётчики фоновой генерации или нулевые счётчики, если она выключена.
+*/
+RandomPrefetchStats get_random_prefetch_stats() noexcept
+{
+    if (!thread_prefetch)
+        return RandomPrefetchStats();
+    return thread_prefetch->get_stats();
+}
+
+/*!
+    \brief Определение набора инструкций
+    \details Определяет лучший набор векторных инструкций, поддерживаемый процессором.
+
+    \return Набор инструкций.
+*/
+SimdLevel detect_SimdLevel()
+{
+#if defined(RANDOM_X86) && defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::avx2;
+#endif
+#if defined(RANDOM_X86) && defined(__SSE2__)
+    return SimdLevel::sse2;
+#else
+    return SimdLevel::scalar;
+#endif
+}
+
+/*!
+    \brief Геттер набора инструкций
+    \details Возвращает набор векторных инструкций, используемый для пакетной генерации.
+
+    \return Набор инструкций.
+*/
+SimdLevel get_SimdLevel() noexcept
+{
+    static const SimdLevel detected = detect_SimdLevel();
+    int forced = forced_SimdLevel.load(std::memory_order_relaxed);
+    if (forced >= 0 && forced < static_cast<int>(detected))
+        return static_cast<SimdLevel>(forced);
+    return detected;
+}
+
+/*!
+    \brief Сеттер набора инструкций
+    \details Ограничивает набор векторных инструкций, используемый для пакетной генерации. Наборы, не поддерживаемые
+   процессором, не включаются.
+
+    \param[in] level максимальный набор инструкций.
+*/
+void set_SimdLevel(const SimdLevel level) noexcept
+{
+    forced_SimdLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+/*!
+    \brief Пакетная генерация без векторных инструкций
+    \details Выполняет count двойных шагов random_lanes генераторов. Каждый двойной шаг даёт 8 чисел: для каждого
+   генератора старшие 32 бита результатов двух последовательных шагов.
+
+    \param[in,out] state ссылка на состояние генератора.
+    \param[out] words указатель на массив для 8 * count чисел.
+    \param[in] count кол-во двойных шагов.
+*/
+void fill_random_scalar(RandomState &state, RandomWord *words, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t step = 0; step < 2; ++step)
+        {
+            for (size_t lane = 0; lane < random_lanes; ++lane)
+            {
+                std::uint64_t s1 = state.lanes_s0[lane];
+                const std::uint64_t s0 = state.lanes_s1[lane];
+                state.lanes_s0[lane] = s0;
+                s1 ^= s1 << 23;
+                state.lanes_s1[lane] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+                words[8 * i + 2 * lane + step] = static_cast<RandomWord>((state.lanes_s1[lane] + s0) >> 32);
+            }
+        }
+    }
+}
+
+#if defined(RANDOM_X86) && defined(__SSE2__)
+/*!
+    \brief Пакетная генерация на SSE2
+    \details То же, что fill_random_scalar, генераторы обрабатываются парами в 128-битных регистрах.
+
+    \param[in,out] state ссылка на состояние генератора.
+    \param[out] words указатель на массив для 8 * count чисел.
+    \param[in] count кол-во двойных шагов.
+*/
+void fill_random_sse2(RandomState &state, RandomWord *words, const size_t count)
+{
+    const __m128i high_mask = _mm_set1_epi64x(static_cast<long long>(0xFFFFFFFF00000000ULL));
+    for (size_t half = 0; half < 2; ++half)
+    {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(state.lanes_s0 + 2 * half));
+        __m128i b = _mm_load_si128(reinterpret_cast<const __m128i *>(state.lanes_s1 + 2 * half));
+        for (size_t i = 0; i < count; ++i)
+        {
+            __m128i out[2];
+            for (size_t step = 0; step < 2; ++step)
+            {
+                __m128i s1 = a;
+                const __m128i s0 = b;
+                a = s0;
+                s1 = _mm_xor_si128(s1, _mm_slli_epi64(s1, 23));
+                b = _mm_xor_si128(_mm_xor_si128(s1, s0), _mm_xor_si128(_mm_srli_epi64(s1, 17), _mm_srli_epi64(s0, 26)));
+                out[step] = _mm_add_epi64(b, s0);
+            }
+            __m128i packed = _mm_or_si128(_mm_srli_epi64(out[0], 32), _mm_and_si128(out[1], high_mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(words + 8 * i + 4 * half), packed);
+        }
+        _mm_store_si128(reinterpret_cast<__m128i *>(state.lanes_s0 + 2 * half), a);
+        _mm_store_si128(reinterpret_cast<__m128i *>(state.lanes_s1 + 2 * half), b);
+    }
+}
+#endif
+
+#if defined(RANDOM_X86) && defined(__GNUC__)
+/*!
+    \brief Пакетная генерация на AVX2
+    \details То же, что fill_random_scalar, все генераторы обрабатываются в одном 256-битном регистре.
+
+    \param[in,out] state ссылка на состояние генератора.
+    \param[out] words указатель на массив для 8 * count чисел.
+    \param[in] count кол-во двойных шагов.
+*/
+__attribute__((target("avx2"))) void fill_random_avx2(RandomState &state, RandomWord *words, const size_t count)
+{
+    const __m256i high_mask = _mm256_set1_epi64x(static_cast<long long>(0xFFFFFFFF00000000ULL));
+    __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i *>(state.lanes_s0));
+    __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i *>(state.lanes_s1));
+    for (size_t i = 0; i < count; ++i)
+    {
+        __m256i out[2];
+        for (size_t step = 0; step < 2; ++step)
+        {
+            __m256i s1 = a;
+            const __m256i s0 = b;
+            a = s0;
+            s1 = _mm256_xor_si256(s1, _mm256_slli_epi64(s1, 23));
+            b = _mm256_xor_si256(_mm256_xor_si256(s1, s0),
+                                 _mm256_xor_si256(_mm256_srli_epi64(s1, 17), _mm256_srli_epi64(s0, 26)));
+            out[step] = _mm256_add_epi64(b, s0);
+        }
+        __m256i packed = _mm256_or_si256(_mm256_srli_epi64(out[0], 32), _mm256_and_si256(out[1], high_mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(words + 8 * i), packed);
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i *>(state.lanes_s0), a);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(state.lanes_s1), b);
+}
+#endif
+
+/*!
+    \brief Пакетная генерация
+    \details Если источником текущего потока выбрана энтропия, копирует числа из буфера энтропии. Иначе заполняет
+   массив words случайными числами пакетного генератора текущего потока, используя лучший доступный набор векторных
+   инструкций. Результат не зависит от набора инструкций. Числа генерируются блоками по 8,
+   остаток последнего блока отбрасывается.
+
+    \param[out] words указатель на массив для случайных чисел.
+    \param[in] count кол-во случайных чисел.
+*/
+void fill_random(RandomWord *words, const size_t count)
+{
+    if (thread_entropy)
+    {
+        read_entropy(words, count);
+        return;
+    }
+    RandomState &state = thread_state();
+    const size_t blocks = count / 8;
+    switch (get_SimdLevel())
+    {
+#if defined(RANDOM_X86) && defined(__GNUC__)
+    case SimdLevel::avx2:
+        fill_random_avx2(state, words, blocks);
+        break;
+#endif
+#if defined(RANDOM_X86) && defined(__SSE2__)
+    case SimdLevel::sse2:
+        fill_random_sse2(state, words, blocks);
+        break;
+#endif
+    default:
+        fill_random_scalar(state, words, blocks);
+    }
+    if (count % 8 != 0)
+    {
+        RandomWord tail[8];
+        fill_random_scalar(state, tail, 1);
+        std::copy(tail, tail + count % 8, words + 8 * blocks);
+    }
+}
+
+/*! @} */
@@ -0,0 +1,72 @@
+/*!
+    \defgroup Random_submodule Генератор случайных чисел
+    \ingroup Dice_module
+    \brief Источник случайных чисел для бросков костей
+*/
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+/*!
+    \addtogroup Random_submodule
+    @{
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+typedef std::uint32_t RandomWord; ///< Равномерно распределённое случайное 32-битное число
+
+/*!
+    \brief Набор векторных инструкций
+    \details Наборы упорядочены по возрастанию ширины регистров.
+*/
+enum class SimdLevel
+{
+    scalar, ///< Без векторных инструкций
+    sse2,   ///< 128-битные регистры
+    avx2    ///< 256-битные регистры
+};
+
+/*!
+    \brief Источник случайных чисел
+    \details Источник выбирается отдельно для каждого потока.
+*/
+enum class RandomSource
+{
+    xorshift, ///< Генератор xorshift128+, воспроизводимый по зерну
+    entropy   ///< Энтропия операционной системы, грани выбираются без смещения
+};
+
+/*!
+    \brief Счётчики фоновой генерации
+    \details Кол-во чисел, сгенерированных фоновым потоком и прочитанных из буфера, и кол-во обращений к пустому
+    буферу.
+*/
+struct RandomPrefetchStats
+{
+        std::uint64_t produced = 0;  ///< Кол-во чисел, записанных в буфер
+        std::uint64_t consumed = 0;  ///< Кол-во чисел, прочитанных из буфера
+        std::uint64_t underruns = 0; ///< Кол-во обращений к пустому буферу
+};
+
+constexpr size_t default_prefetch_capacity = size_t(1) << 16; ///< Ёмкость буфера фоновой генерации по умолчанию
+constexpr size_t entropy_buffer_words = size_t(1) << 14;      ///< Кол-во чисел, читаемых из энтропии за один раз
+
+void seed_random(const std::uint64_t seed);
+RandomWord random_word();
+RandomWord random_below(const RandomWord bound);
+void fill_random(RandomWord *words, const size_t count);
+
+void set_random_source(const RandomSource source);
+RandomSource get_random_source() noexcept;
+
+void start_random_prefetch(const size_t capacity = default_prefetch_capacity);
+void stop_random_prefetch() noexcept;
+RandomPrefetchStats get_random_prefetch_stats() noexcept;
+
+SimdLevel get_SimdLevel() noexcept;
+void set_SimdLevel(const SimdLevel level) noexcept;
+
+/*! @} */
+
+#endif // RANDOM_HPP
@@ -0,0 +1,281 @@
+#include "reduce.hpp"
+
+/*!
+    \addtogroup Reduce_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "../random/random.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REDUCE_X86
+#endif
+
+constexpr size_t count_block = 4096; ///< Кол-во значений, обрабатываемых за один проход по граням
+
+/*!
+    \brief Сумма без векторных инструкций
+    \details Суммирует значения в 64-битный аккумулятор.
+
+    \param[in] values указатель на массив значений.
+    \param[in] count кол-во значений.
+
+    \return Сумму значений.
+*/
+std::uint64_t sum_values_scalar(const PackedNumPoints *values, const size_t count) noexcept
+{
+    std::uint64_t total = 0;
+    for (size_t i = 0; i < count; ++i)
+        total += values[i];
+    return total;
+}
+
+/*!
+    \brief Кол-во значений без векторных инструкций
+    \details Добавляет в counts кол-во каждого значения от 0 до faces. Остальные значения не учитываются.
+
+    \param[in] values указатель на массив значений.
+    \param[in] count кол-во значений.
+    \param[in] faces кол-во граней кости.
+    \param[in,out] counts указатель на массив из faces + 1 счётчиков.
+*/
+void count_faces_scalar(const PackedNumPoints *values, const size_t count, const size_t faces, size_t *counts) noexcept
+{
+    for (size_t i = 0; i < count; ++i)
+        if (values[i] <= faces)
+            ++counts[values[i]];
+}
+
+#if defined(REDUCE_X86) && defined(__SSE2__)
+/*!
+    \brief Сумма на SSE2
+    \details Складывает по 16 значений за шаг инструкцией psadbw, которая суммирует байты в два 64-битных
+   аккумулятора.
+
+    \param[in] values указатель на массив значений.
+    \param[in] count кол-во значений.
+
+    \return Сумму значений.
+*/
+std::uint64_t sum_values_sse2(const PackedNumPoints *values, const size_t count) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = zero;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+        total = _mm_add_epi64(
+            total, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i)), zero));
+    std::uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), total);
+    return lanes[0] + lanes[1] + sum_values_scalar(values + i, count - i);
+}
+
+/*!
+    \brief Кол-во значений на SSE2
+    \details То же, что count_faces_scalar, по 16 значений за шаг: совпадения с гранью отмечаются единицами и
+   суммируются инструкцией psadbw. Массив обрабатывается блоками по count_block, чтобы проходы по граням читали блок из
+   кэша.
+
+    \param[in] values указатель на массив значений.
+    \param[in] count кол-во значений.
+    \param[in] faces кол-во граней кости.
+    \param[in,out] counts указатель на массив из faces + 1 счётчиков.
+*/
+void count_faces_sse2(const PackedNumPoints *values, const size_t count, const size_t faces, size_t *counts) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    const size_t vector_count = count - count % 16;
+    for (size_t first = 0; first < vector_count; first += count_block)
+    {
+        const size_t last = std::min(vector_count, first + count_block);
+        for (size_t face = 0; face <= faces; ++face)
+        {
+            const __m128i needle = _mm_set1_epi8(static_cast<char>(face));
+            __m128i total = zero;
+            for (size_t i = first; i < last; i += 16)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+                total = _mm_add_epi64(total, _mm_sad_epu8(_mm_and_si128(_mm_cmpeq_epi8(v, needle), one), zero));
+            }
+            std::uint64_t lanes[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), total);
+            counts[face] += lanes[0] + lanes[1];
+        }
+    }
+    count_faces_scalar(values + vector_count, count - vector_count, faces, counts);
+}
+#endif
+
+#if defined(REDUCE_X86) && defined(__GNUC__)
+/*!
+    \brief Сумма на AVX2
+    \details То же, что sum_values_sse2, по 32 значения за шаг.
+
+    \param[in] values указатель на массив значений.
+    \param[in] count кол-во значений.
+
+    \return Сумму значений.
+*/
+__attribute__((target("avx2"))) std::uint64_t sum_values_avx2(const PackedNumPoints *values,
+                                                               const size_t count) noexcept
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = zero;
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32)
+        total = _mm256_add_epi64(
+            total, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i)), zero));
+    std::uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_values_scalar(values + i, count - i);
+}
+
+/*!
+    \brief Кол-во значений на AVX2
+    \details То же, что count_faces_sse2, по 32 значения за шаг.
+
+    \param[in] values указатель на массив значений.
+    \param[in] count кол-во значений.
+    \param[in] faces кол-во граней кости.
+    \param[in,out] counts указатель на массив из faces + 1 счётчиков.
+*/
+__attribute__((target("avx2"))) void count_faces_avx2(const PackedNumPoints *values, const size_t count,
+                                                      const size_t faces, size_t *counts) noexcept
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    const size_t vector_count = count - count % 32;
+    for (size_t first = 0; first < vector_count; first += count_block)
+    {
+        const size_t last = std::min(vector_count, first + count_block);
+        for (size_t face = 0; face <= faces; ++face)
+        {
+            const __m256i needle = _mm256_set1_epi8(static_cast<char>(face));
+            __m256i total = zero;
+            for (size_t i = first; i < last; i += 32)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+                total = _mm256_add_epi64(total,
+                                         _mm256_sad_epu8(_mm256_and_si256(_mm256_cmpeq_epi8(v, needle), one), zero));
+            }
+            std::uint64_t lanes[4];
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
+            counts[face] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        }
+    }
+    count_faces_scalar(values + vector_count, count - vector_count, faces, counts);
+}
+#endif
+
+/*!
+    \brief Сумма значений
+    \details Суммирует значения в 64-битный аккумулятор, используя лучший доступный набор векторных инструкций.
+
+    \param[in] values указатель на массив значений.
+    \param[in] count кол-во значений.
+
+    \return Сумму значений.
+*/
+std::uint64_t sum_values(const PackedNumPoints *values, const size_t count) noexcept
+{
+    switch (get_SimdLevel())
+    {
+#if defined(REDUCE_X86) && defined(__GNUC__)
+    case SimdLevel::avx2:
+        return sum_values_avx2(values, count);
+#endif
+#if defined(REDUCE_X86) && defined(__SSE2__)
+    case SimdLevel::sse2:
+        return sum_values_sse2(values, count);
+#endif
+    default:
+        return sum_values_scalar(values, count);
+    }
+}
+
+/*!
+    \brief Параллельная сумма значений
+    \details Делит массив на threads непрерывных частей, суммирует их в отдельных потоках и складывает результаты.
+   На каждый поток приходится не меньше parallel_reduce_min значений. Если поток не удалось запустить, его часть
+   суммирует текущий поток.
+
+    \param[in] values указатель на массив значений.
+    \param[in] count кол-во значений.
+    \param[in] threads кол-во потоков, 0 - по кол-ву ядер.
+
+    \return Сумму значений.
+*/
+std::uint64_t sum_values(const PackedNumPoints *values, const size_t count, size_t threads)
+{
+    if (threads == 0)
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    threads = std::max<size_t>(std::min(threads, count / parallel_reduce_min), 1);
+    if (threads == 1)
+        return sum_values(values, count);
+
+    const size_t part = (count + threads - 1) / threads;
+    std::vector<std::uint64_t> totals(threads, 0);
+    std::vector<std::thread> workers;
+    size_t started = 1;
+    for (; started < threads; ++started)
+    {
+        const size_t first = started * part;
+        const size_t length = std::min(count, first + part) - first;
+        try
+        {
+            workers.emplace_back([values, first, length, &totals, started]()
+                                 { totals[started] = sum_values(values + first, length); });
+        }
+        catch (const std::system_error &)
+        {
+            break;
+        }
+    }
+    totals[0] = sum_values(values, part);
+    for (size_t t = started; t < threads; ++t)
+        totals[t] = sum_values(values + t * part, std::min(count, (t + 1) * part) - t * part);
+    for (std::thread &worker : workers)
+        worker.join();
+    std::uint64_t total = 0;
+    for (std::uint64_t part_total : totals)
+        total += part_total;
+    return total;
+}
+
+/*!
+    \brief Кол-во значений
+    \details Добавляет в counts кол-во каждого значения от 0 до faces, используя лучший доступный набор векторных
+   инструкций. Остальные значения не учитываются.
+
+    \param[in] values указатель на массив значений.
+    \param[in] count кол-во значений.
+    \param[in] faces кол-во граней кости.
+    \param[in,out] counts указатель на массив из faces + 1 счётчиков.
+*/
+void count_faces(const PackedNumPoints *values, const size_t count, const size_t faces, size_t *counts) noexcept
+{
+    switch (get_SimdLevel())
+    {
+#if defined(REDUCE_X86) && defined(__GNUC__)
+    case SimdLevel::avx2:
+        count_faces_avx2(values, count, faces, counts);
+        break;
+#endif
+#if defined(REDUCE_X86) && defined(__SSE2__)
+    case SimdLevel::sse2:
+        count_faces_sse2(values, count, faces, counts);
+        break;
+#endif
+    default:
+        count_faces_scalar(values, count, faces, counts);
+    }
+}
+
+/*! @} */
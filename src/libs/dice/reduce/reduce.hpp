@@ -0,0 +1,26 @@
+/*!
+    \defgroup Reduce_submodule Свёртка значений
+    \ingroup Dice_module
+    \brief Сумма и кол-во значений в плотном массиве значений костей
+*/
+#ifndef REDUCE_HPP
+#define REDUCE_HPP
+
+/*!
+    \addtogroup Reduce_submodule
+    @{
+*/
+
+#include <cstdint>
+
+#include "../oneDice/odds/odds.hpp"
+
+constexpr size_t parallel_reduce_min = size_t(1) << 22; ///< Мин. кол-во значений на поток при параллельной свёртке
+
+std::uint64_t sum_values(const PackedNumPoints *values, const size_t count) noexcept;
+std::uint64_t sum_values(const PackedNumPoints *values, const size_t count, size_t threads);
+void count_faces(const PackedNumPoints *values, const size_t count, const size_t faces, size_t *counts) noexcept;
+
+/*! @} */
+
+#endif // REDUCE_HPP
@@ -0,0 +1,307 @@
+#include "sampling.hpp"
+
+/*!
+    \addtogroup Sampling_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <cstdint>
+
+#include "../oneDice/oneDice.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SAMPLING_X86
+#endif
+
+constexpr size_t sampling_block = 256; ///< Кол-во граней, генерируемых за один проход
+
+/*!
+    \brief Грани "честной" кости без векторных инструкций
+    \details Заменяет каждое случайное число в массиве гранью, полученной умножением и сдвигом.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in,out] words указатель на массив случайных чисел.
+    \param[in] count кол-во чисел.
+*/
+template <size_t Faces> void fair_faces_scalar(RandomWord *words, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        words[i] = static_cast<RandomWord>(((static_cast<std::uint64_t>(words[i]) * Faces) >> 32) + 1);
+}
+
+/*!
+    \brief Грани по таблице без векторных инструкций
+    \details Заменяет каждое случайное число в массиве гранью: Faces минус кол-во порогов, больших числа, но не больше
+   последней грани с ненулевым шансом.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] table ссылка на таблицу выбора грани.
+    \param[in,out] words указатель на массив случайных чисел.
+    \param[in] count кол-во чисел.
+*/
+template <size_t Faces> void table_faces_scalar(const OddsTable<Faces> &table, RandomWord *words, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        RandomWord face = Faces;
+        for (size_t t = 0; t < Faces - 1; ++t)
+            face -= table.thresholds[t] > words[i];
+        words[i] = std::min<RandomWord>(face, table.last_face);
+    }
+}
+
+#if defined(SAMPLING_X86) && defined(__SSE2__)
+/*!
+    \brief Грани "честной" кости на SSE2
+    \details То же, что fair_faces_scalar, по 4 числа за шаг.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in,out] words указатель на массив случайных чисел.
+    \param[in] count кол-во чисел.
+*/
+template <size_t Faces> void fair_faces_sse2(RandomWord *words, const size_t count)
+{
+    const __m128i faces = _mm_set1_epi32(Faces);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i high_mask = _mm_set1_epi64x(static_cast<long long>(0xFFFFFFFF00000000ULL));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words + i));
+        __m128i even = _mm_mul_epu32(w, faces);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(w, 32), faces);
+        __m128i face = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, high_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(words + i), _mm_add_epi32(face, one));
+    }
+    fair_faces_scalar<Faces>(words + i, count - i);
+}
+
+/*!
+    \brief Грани по таблице на SSE2
+    \details То же, что table_faces_scalar, по 4 числа за шаг. Беззнаковое сравнение выполняется знаковым после
+   инвертирования старшего бита.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] table ссылка на таблицу выбора грани.
+    \param[in,out] words указатель на массив случайных чисел.
+    \param[in] count кол-во чисел.
+*/
+template <size_t Faces> void table_faces_sse2(const OddsTable<Faces> &table, RandomWord *words, const size_t count)
+{
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i faces = _mm_set1_epi32(Faces);
+    const __m128i last = _mm_set1_epi32(table.last_face);
+    __m128i thresholds[Faces - 1];
+    for (size_t t = 0; t < Faces - 1; ++t)
+        thresholds[t] = _mm_set1_epi32(static_cast<int>(table.thresholds[t] ^ 0x80000000u));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i w = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(words + i)), bias);
+        __m128i face = faces;
+        for (size_t t = 0; t < Faces - 1; ++t)
+            face = _mm_add_epi32(face, _mm_cmpgt_epi32(thresholds[t], w));
+        __m128i over = _mm_cmpgt_epi32(face, last);
+        face = _mm_or_si128(_mm_andnot_si128(over, face), _mm_and_si128(over, last));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(words + i), face);
+    }
+    table_faces_scalar(table, words + i, count - i);
+}
+#endif
+
+#if defined(SAMPLING_X86) && defined(__GNUC__)
+/*!
+    \brief Грани "честной" кости на AVX2
+    \details То же, что fair_faces_scalar, по 8 чисел за шаг.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in,out] words указатель на массив случайных чисел.
+    \param[in] count кол-во чисел.
+*/
+template <size_t Faces> __attribute__((target("avx2"))) void fair_faces_avx2(RandomWord *words, const size_t count)
+{
+    const __m256i faces = _mm256_set1_epi32(Faces);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i high_mask = _mm256_set1_epi64x(static_cast<long long>(0xFFFFFFFF00000000ULL));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+        __m256i even = _mm256_mul_epu32(w, faces);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(w, 32), faces);
+        __m256i face = _mm256_or_si256(_mm256_srli_epi64(even, 32), _mm256_and_si256(odd, high_mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(words + i), _mm256_add_epi32(face, one));
+    }
+    fair_faces_scalar<Faces>(words + i, count - i);
+}
+
+/*!
+    \brief Грани по таблице на AVX2
+    \details То же, что table_faces_scalar, по 8 чисел за шаг.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] table ссылка на таблицу выбора грани.
+    \param[in,out] words указатель на массив случайных чисел.
+    \param[in] count кол-во чисел.
+*/
+template <size_t Faces>
+__attribute__((target("avx2"))) void table_faces_avx2(const OddsTable<Faces> &table, RandomWord *words,
+                                                      const size_t count)
+{
+    const __m256i bias = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256i faces = _mm256_set1_epi32(Faces);
+    const __m256i last = _mm256_set1_epi32(table.last_face);
+    __m256i thresholds[Faces - 1];
+    for (size_t t = 0; t < Faces - 1; ++t)
+        thresholds[t] = _mm256_set1_epi32(static_cast<int>(table.thresholds[t] ^ 0x80000000u));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i w = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i)), bias);
+        __m256i face = faces;
+        for (size_t t = 0; t < Faces - 1; ++t)
+            face = _mm256_add_epi32(face, _mm256_cmpgt_epi32(thresholds[t], w));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(words + i), _mm256_min_epi32(face, last));
+    }
+    table_faces_scalar(table, words + i, count - i);
+}
+#endif
+
+/*!
+    \brief Перевод случайных чисел в грани
+    \details Заменяет случайные числа гранями, используя лучший доступный набор векторных инструкций. Результат не
+   зависит от набора инструкций.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] table указатель на таблицу выбора грани или nullptr для "честной" кости.
+    \param[in,out] words указатель на массив случайных чисел.
+    \param[in] count кол-во чисел.
+*/
+template <size_t Faces> void words_to_faces(const OddsTable<Faces> *table, RandomWord *words, const size_t count)
+{
+    bool fair = table == nullptr || table->fair;
+    switch (get_SimdLevel())
+    {
+#if defined(SAMPLING_X86) && defined(__GNUC__)
+    case SimdLevel::avx2:
+        fair ? fair_faces_avx2<Faces>(words, count) : table_faces_avx2(*table, words, count);
+        break;
+#endif
+#if defined(SAMPLING_X86) && defined(__SSE2__)
+    case SimdLevel::sse2:
+        fair ? fair_faces_sse2<Faces>(words, count) : table_faces_sse2(*table, words, count);
+        break;
+#endif
+    default:
+        fair ? fair_faces_scalar<Faces>(words, count) : table_faces_scalar(*table, words, count);
+    }
+}
+
+/*!
+    \brief Пакетная генерация граней
+    \details Заполняет массив faces случайными гранями блоками по sampling_block: для каждого блока пакетно генерируются
+   случайные числа, которые затем сравниваются с порогами таблицы векторными инструкциями.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] table указатель на таблицу выбора грани или nullptr для "честной" кости.
+    \param[out] faces указатель на массив для граней.
+    \param[in] count кол-во граней.
+*/
+template <size_t Faces> void fill_faces(const OddsTable<Faces> *table, NumPoints *faces, size_t count)
+{
+    alignas(32) RandomWord words[sampling_block];
+    while (count > 0)
+    {
+        size_t block = std::min(count, sampling_block);
+        fill_random(words, block);
+        words_to_faces(table, words, block);
+        std::copy(words, words + block, faces);
+        faces += block;
+        count -= block;
+    }
+}
+
+/*!
+    \brief Пакетная генерация граней
+    \details Заполняет массив faces случайными гранями кости с шансами из реестра. Для "честной" кости реестр не
+   используется. Если источником случайных чисел выбрана энтропия, грани выбираются по одной без смещения.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] handle номер шансов выпадения граней в реестре.
+    \param[out] faces указатель на массив для граней.
+    \param[in] count кол-во граней.
+
+    \throw std::out_of_range - если в реестре нет шансов с номером handle.
+*/
+template <size_t Faces> void random_odds(const OddsHandle handle, NumPoints *faces, const size_t count)
+{
+    if (get_random_source() == RandomSource::entropy)
+    {
+        std::generate(faces, faces + count, [handle]() { return random_odds<Faces>(handle); });
+        return;
+    }
+    if (handle == fair_odds_handle)
+        fill_faces<Faces>(nullptr, faces, count);
+    else
+        fill_faces(&OddsRegistry<Faces>::get_table(handle), faces, count);
+}
+
+/*!
+    \brief Перевод заданных случайных чисел в грани
+    \details Заполняет массив faces гранями кости с шансами из реестра, выбранными по случайным числам words. Нужна
+   для генераторов, числа которых получены не из fill_random, например для генератора на счётчике.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] handle номер шансов выпадения граней в реестре.
+    \param[in] words указатель на массив случайных чисел.
+    \param[out] faces указатель на массив для граней.
+    \param[in] count кол-во граней.
+
+    \throw std::out_of_range - если в реестре нет шансов с номером handle.
+*/
+template <size_t Faces>
+void words_to_faces(const OddsHandle handle, const RandomWord *words, NumPoints *faces, size_t count)
+{
+    const OddsTable<Faces> *table = handle == fair_odds_handle ? nullptr : &OddsRegistry<Faces>::get_table(handle);
+    alignas(32) RandomWord block_words[sampling_block];
+    while (count > 0)
+    {
+        size_t block = std::min(count, sampling_block);
+        std::copy(words, words + block, block_words);
+        words_to_faces(table, block_words, block);
+        std::copy(block_words, block_words + block, faces);
+        words += block;
+        faces += block;
+        count -= block;
+    }
+}
+
+template void random_odds<4>(const OddsHandle handle, NumPoints *faces, const size_t count);
+template void random_odds<6>(const OddsHandle handle, NumPoints *faces, const size_t count);
+template void random_odds<8>(const OddsHandle handle, NumPoints *faces, const size_t count);
+template void random_odds<10>(const OddsHandle handle, NumPoints *faces, const size_t count);
+template void random_odds<12>(const OddsHandle handle, NumPoints *faces, const size_t count);
+template void random_odds<20>(const OddsHandle handle, NumPoints *faces, const size_t count);
+template void random_odds<100>(const OddsHandle handle, NumPoints *faces, const size_t count);
+
+template void words_to_faces<4>(const OddsHandle handle, const RandomWord *words, NumPoints *faces, size_t count);
+template void words_to_faces<6>(const OddsHandle handle, const RandomWord *words, NumPoints *faces, size_t count);
+template void words_to_faces<8>(const OddsHandle handle, const RandomWord *words, NumPoints *faces, size_t count);
+template void words_to_faces<10>(const OddsHandle handle, const RandomWord *words, NumPoints *faces, size_t count);
+template void words_to_faces<12>(const OddsHandle handle, const RandomWord *words, NumPoints *faces, size_t count);
+template void words_to_faces<20>(const OddsHandle handle, const RandomWord *words, NumPoints *faces, size_t count);
+template void words_to_faces<100>(const OddsHandle handle, const RandomWord *words, NumPoints *faces, size_t count);
+
+/*! @} */
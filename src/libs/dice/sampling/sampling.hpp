@@ -0,0 +1,23 @@
+/*!
+    \defgroup Sampling_submodule Пакетная генерация граней
+    \ingroup Dice_module
+    \brief Генерация граней сразу для многих костей
+*/
+#ifndef SAMPLING_HPP
+#define SAMPLING_HPP
+
+/*!
+    \addtogroup Sampling_submodule
+    @{
+*/
+
+#include "../oneDice/odds/registry/registry.hpp"
+#include "../random/random.hpp"
+
+template <size_t Faces> void random_odds(const OddsHandle handle, NumPoints *faces, const size_t count);
+template <size_t Faces>
+void words_to_faces(const OddsHandle handle, const RandomWord *words, NumPoints *faces, size_t count);
+
+/*! @} */
+
+#endif // SAMPLING_HPP
@@ -0,0 +1,275 @@
+#include "scoring.hpp"
+
+/*!
+    \addtogroup Scoring_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <stdexcept>
+
+static_assert(OneDice::faces == 6, "Signature layout assumes six faces");
+
+/*!
+    \brief Вес значения в сигнатуре
+    \details Вес значения v равен signature_base^(v - 1). Индекс берётся по младшим трём битам значения, поэтому
+   веса для 0 и 7 равны 0.
+*/
+static const FaceSignature face_weights[8] = {0,
+                                              1,
+                                              signature_base,
+                                              signature_base * signature_base,
+                                              signature_base * signature_base * signature_base,
+                                              signature_base * signature_base * signature_base * signature_base,
+                                              signature_base * signature_base * signature_base * signature_base *
+                                                  signature_base,
+                                              0};
+
+/*!
+    \brief Подсчёт комбинаций
+    \details Находит комбинации и их очки по кол-ву костей с каждым значением.
+
+    \param[in] counts указатель на кол-ва костей со значениями 1..OneDice::faces.
+
+    \return Очки комбинаций.
+*/
+static PatternScores compute_PatternScores(const size_t *counts)
+{
+    PatternScores result = {};
+    size_t sum = 0, most = 0, run = 0, longest = 0;
+    size_t pairs[2] = {};
+    for (size_t face = OneDice::faces; face >= 1; --face)
+    {
+        sum += face * counts[face];
+        most = std::max(most, counts[face]);
+        run = counts[face] > 0 ? run + 1 : 0;
+        longest = std::max(longest, run);
+        if (counts[face] >= 2)
+        {
+            if (pairs[0] == 0)
+                pairs[0] = face;
+            else if (pairs[1] == 0)
+                pairs[1] = face;
+        }
+    }
+    bool full_house = false;
+    for (size_t three = 1; three <= OneDice::faces; ++three)
+        for (size_t two = 1; two <= OneDice::faces; ++two)
+            full_house = full_house || (three != two && counts[three] >= 3 && counts[two] >= 2);
+
+    unsigned scores[pattern_count] = {};
+    scores[static_cast<size_t>(Pattern::pair)] = static_cast<unsigned>(2 * pairs[0]);
+    scores[static_cast<size_t>(Pattern::two_pairs)] = pairs[1] != 0 ? static_cast<unsigned>(2 * (pairs[0] + pairs[1])) : 0;
+    scores[static_cast<size_t>(Pattern::three_of_a_kind)] = most >= 3 ? static_cast<unsigned>(sum) : 0;
+    scores[static_cast<size_t>(Pattern::four_of_a_kind)] = most >= 4 ? static_cast<unsigned>(sum) : 0;
+    scores[static_cast<size_t>(Pattern::full_house)] = full_house ? 25 : 0;
+    scores[static_cast<size_t>(Pattern::small_straight)] = longest >= 4 ? 30 : 0;
+    scores[static_cast<size_t>(Pattern::large_straight)] = longest >= 5 ? 40 : 0;
+    scores[static_cast<size_t>(Pattern::yahtzee)] = most >= 5 ? 50 : 0;
+    scores[static_cast<size_t>(Pattern::chance)] = static_cast<unsigned>(sum);
+    for (size_t pattern = 0; pattern < pattern_count; ++pattern)
+    {
+        result.scores[pattern] = static_cast<std::uint8_t>(scores[pattern]);
+        if (scores[pattern] != 0)
+            result.mask |= static_cast<PatternMask>(1u << pattern);
+    }
+    return result;
+}
+
+/*!
+    \brief Таблица комбинаций
+    \details Заполняется при первом обращении для всех сигнатур групп до max_pattern_dice костей. Записи для
+   сигнатур, не соответствующих ни одной группе, нулевые.
+
+    \return Ссылка на таблицу, индексируемую сигнатурой.
+*/
+static const Vector<PatternScores> &get_pattern_table()
+{
+    static const Vector<PatternScores> table = []
+    {
+        Vector<PatternScores> result(signature_count, PatternScores());
+        PatternScores *entry = result.get_data();
+        for (size_t signature = 0; signature < signature_count; ++signature)
+        {
+            size_t counts[OneDice::faces + 1] = {};
+            size_t total = 0;
+            for (size_t face = 1, rest = signature; face <= OneDice::faces; ++face, rest /= signature_base)
+            {
+                counts[face] = rest % signature_base;
+                total += counts[face];
+            }
+            if (total <= max_pattern_dice)
+                entry[signature] = compute_PatternScores(counts);
+        }
+        return result;
+    }();
+    return table;
+}
+
+/*!
+    \brief Сигнатура без проверки размера
+    \details Складывает веса значений за один проход без ветвлений и отмечает в invalid значения, которые не могут
+   являться значением кости.
+
+    \param[in] values указатель на значения костей.
+    \param[in] count кол-во значений, не больше max_pattern_dice.
+    \param[in,out] invalid ссылка на признак неверного значения.
+
+    \return Сигнатура группы.
+*/
+static FaceSignature group_signature(const PackedNumPoints *values, const size_t count, bool &invalid) noexcept
+{
+    FaceSignature signature = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        invalid |= static_cast<unsigned>(values[i] - 1) >= OneDice::faces;
+        signature += face_weights[values[i] & 7];
+    }
+    return signature;
+}
+
+/*!
+    \brief Сигнатура группы значений
+    \param[in] values указатель на значения костей.
+    \param[in] count кол-во значений.
+
+    \return Сигнатура группы.
+
+    \throw std::length_error - если count больше max_pattern_dice.
+    \throw std::invalid_argument - если среди значений есть значение, которое не может являться значением кости.
+*/
+FaceSignature to_FaceSignature(const PackedNumPoints *values, const size_t count)
+{
+    if (count > max_pattern_dice)
+        throw std::length_error("Too many dice for pattern scoring!");
+    bool invalid = false;
+    FaceSignature signature = group_signature(values, count, invalid);
+    if (invalid)
+        throw std::invalid_argument("Invalid value!");
+    return signature;
+}
+
+/*!
+    \brief Сигнатура группы костей
+    \details Берёт кол-ва костей с каждым значением, которые группа поддерживает сама, и работает за O(1).
+
+    \param[in] dice ссылка на группу костей.
+
+    \return Сигнатура группы.
+
+    \throw std::length_error - если в группе больше max_pattern_dice костей.
+*/
+FaceSignature to_FaceSignature(const Dice &dice)
+{
+    if (dice.get_size() > max_pattern_dice)
+        throw std::length_error("Too many dice for pattern scoring!");
+    FaceSignature signature = 0;
+    for (NumPoints face = 1; face <= OneDice::faces; ++face)
+        signature += static_cast<FaceSignature>(dice.count_NumPoints(face)) * face_weights[face];
+    return signature;
+}
+
+/*!
+    \brief Геттер очков комбинаций
+    \param[in] signature сигнатура группы.
+
+    \return Ссылка на запись таблицы с набором комбинаций и очками.
+
+    \throw std::out_of_range - если signature не является сигнатурой группы.
+*/
+const PatternScores &get_PatternScores(const FaceSignature signature)
+{
+    if (signature >= signature_count)
+        throw std::out_of_range("Invalid signature!");
+    return get_pattern_table().get_data()[signature];
+}
+
+/*!
+    \brief Очки комбинации
+    \param[in] signature сигнатура группы.
+    \param[in] pattern комбинация.
+
+    \return Очки комбинации pattern или 0, если её нет в группе.
+
+    \throw std::out_of_range - если signature не является сигнатурой группы.
+*/
+unsigned score_Pattern(const FaceSignature signature, const Pattern pattern)
+{
+    return get_PatternScores(signature).scores[static_cast<size_t>(pattern)];
+}
+
+/*!
+    \brief Поиск комбинаций
+    \param[in] signature сигнатура группы.
+
+    \return Набор комбинаций, которые есть в группе.
+
+    \throw std::out_of_range - если signature не является сигнатурой группы.
+*/
+PatternMask match_Patterns(const FaceSignature signature)
+{
+    return get_PatternScores(signature).mask;
+}
+
+/*!
+    \brief Подсчёт очков множества групп
+    \details Значения групп идут подряд: группа i занимает values[i * group_size]..values[(i + 1) * group_size - 1].
+   Для каждой группы сигнатура считается одним проходом, а очки берутся из таблицы, поэтому на группу приходится
+   group_size сложений и одно обращение к таблице.
+
+    \param[in] values указатель на значения всех групп.
+    \param[in] group_size кол-во костей в группе.
+    \param[in] groups кол-во групп.
+    \param[in] pattern комбинация.
+    \param[out] scores указатель на массив из groups очков.
+
+    \throw std::length_error - если group_size больше max_pattern_dice.
+    \throw std::invalid_argument - если среди значений есть значение, которое не может являться значением кости. Очки
+   при этом могут быть записаны частично.
+*/
+void score_groups(const PackedNumPoints *values, const size_t group_size, const size_t groups, const Pattern pattern,
+                  unsigned *scores)
+{
+    if (group_size > max_pattern_dice)
+        throw std::length_error("Too many dice for pattern scoring!");
+    const PatternScores *table = get_pattern_table().get_data();
+    const size_t index = static_cast<size_t>(pattern);
+    bool invalid = false;
+    for (size_t group = 0; group < groups; ++group, values += group_size)
+    {
+        FaceSignature signature = group_signature(values, group_size, invalid);
+        scores[group] = table[signature].scores[index];
+    }
+    if (invalid)
+        throw std::invalid_argument("Invalid value!");
+}
+
+/*!
+    \brief Поиск комбинаций в множестве групп
+    \details Значения групп идут подряд, как в score_groups.
+
+    \param[in] values указатель на значения всех групп.
+    \param[in] group_size кол-во костей в группе.
+    \param[in] groups кол-во групп.
+    \param[out] masks указатель на массив из groups наборов комбинаций.
+
+    \throw std::length_error - если group_size больше max_pattern_dice.
+    \throw std::invalid_argument - если среди значений есть значение, которое не может являться значением кости.
+   Наборы при этом могут быть записаны частично.
+*/
+void match_groups(const PackedNumPoints *values, const size_t group_size, const size_t groups, PatternMask *masks)
+{
+    if (group_size > max_pattern_dice)
+        throw std::length_error("Too many dice for pattern scoring!");
+    const PatternScores *table = get_pattern_table().get_data();
+    bool invalid = false;
+    for (size_t group = 0; group < groups; ++group, values += group_size)
+    {
+        FaceSignature signature = group_signature(values, group_size, invalid);
+        masks[group] = table[signature].mask;
+    }
+    if (invalid)
+        throw std::invalid_argument("Invalid value!");
+}
+
+/*! @} */
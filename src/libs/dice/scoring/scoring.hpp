@@ -0,0 +1,80 @@
+/*!
+    \defgroup Scoring_submodule Подсчёт комбинаций
+    \ingroup Dice_module
+    \brief Поиск и подсчёт очков комбинаций по таблицам, заполненным заранее
+*/
+#ifndef SCORING_HPP
+#define SCORING_HPP
+
+/*!
+    \addtogroup Scoring_submodule
+    @{
+*/
+
+#include <cstdint>
+
+#include "../dice.hpp"
+
+constexpr size_t max_pattern_dice = 6; ///< Максимальное кол-во костей в группе для подсчёта комбинаций
+
+/*!
+    \brief Комбинация
+    \details Очки считаются по правилам Yahtzee, пары - по правилам Yatzy.
+*/
+enum class Pattern
+{
+    pair,            ///< Пара: сумма старшей пары
+    two_pairs,       ///< Две пары разных значений: сумма двух старших пар
+    three_of_a_kind, ///< Три одинаковых: сумма всех костей
+    four_of_a_kind,  ///< Четыре одинаковых: сумма всех костей
+    full_house,      ///< Три одинаковых и пара другого значения: 25 очков
+    small_straight,  ///< Четыре значения подряд: 30 очков
+    large_straight,  ///< Пять значений подряд: 40 очков
+    yahtzee,         ///< Пять одинаковых: 50 очков
+    chance           ///< Любая группа: сумма всех костей
+};
+
+constexpr size_t pattern_count = 9; ///< Кол-во комбинаций
+
+typedef std::uint32_t FaceSignature; ///< Кол-во костей с каждым значением, записанное в системе счисления max_pattern_dice + 1
+typedef std::uint16_t PatternMask;   ///< Набор комбинаций, каждой соответствует бит с номером комбинации
+
+constexpr FaceSignature signature_base = max_pattern_dice + 1; ///< Основание системы счисления сигнатуры
+constexpr size_t signature_count = size_t(signature_base) * signature_base * signature_base * signature_base *
+                                   signature_base * signature_base; ///< Кол-во сигнатур групп до max_pattern_dice костей
+
+/*!
+    \brief Перевод комбинации в набор
+    \param[in] pattern комбинация.
+
+    \return Набор из одной комбинации pattern.
+*/
+constexpr PatternMask to_PatternMask(const Pattern pattern)
+{
+    return static_cast<PatternMask>(1u << static_cast<unsigned>(pattern));
+}
+
+/*!
+    \brief Очки комбинаций
+    \details Набор комбинаций, которые есть в группе, и очки каждой комбинации. Отсутствующая комбинация даёт 0 очков.
+*/
+struct PatternScores
+{
+        PatternMask mask;                   ///< Набор найденных комбинаций
+        std::uint8_t scores[pattern_count]; ///< Очки каждой комбинации
+};
+
+FaceSignature to_FaceSignature(const PackedNumPoints *values, const size_t count);
+FaceSignature to_FaceSignature(const Dice &dice);
+
+const PatternScores &get_PatternScores(const FaceSignature signature);
+unsigned score_Pattern(const FaceSignature signature, const Pattern pattern);
+PatternMask match_Patterns(const FaceSignature signature);
+
+void score_groups(const PackedNumPoints *values, const size_t group_size, const size_t groups, const Pattern pattern,
+                  unsigned *scores);
+void match_groups(const PackedNumPoints *values, const size_t group_size, const size_t groups, PatternMask *masks);
+
+/*! @} */
+
+#endif // SCORING_HPP
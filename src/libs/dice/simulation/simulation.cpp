@@ -0,0 +1,236 @@
+#include "simulation.hpp"
+
+/*!
+    \addtogroup Simulation_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+constexpr size_t simulation_block = size_t(1) << 16; ///< Кол-во граней, генерируемых потоком за один проход
+constexpr size_t max_block_trials = 4096;            ///< Максимальное кол-во испытаний в одном проходе
+
+/*!
+    \brief Грани блока испытаний
+    \details Бросает все кости группы в trials испытаниях. Грани хранятся по столбцам: грань кости i в испытании t
+   записывается в faces[i * trials + t]. Подряд идущие кости с одинаковыми шансами бросаются одним пакетом.
+
+    \param[in] handles указатель на массив номеров шансов костей.
+    \param[in] size кол-во костей.
+    \param[in] trials кол-во испытаний.
+    \param[out] faces указатель на массив из size * trials граней.
+*/
+void roll_block_faces(const OddsHandle *handles, const size_t size, const size_t trials, NumPoints *faces)
+{
+    size_t first = 0;
+    while (first < size)
+    {
+        size_t last = first + 1;
+        while (last < size && handles[last] == handles[first])
+            ++last;
+        random_odds<OneDice::faces>(handles[first], faces + first * trials, (last - first) * trials);
+        first = last;
+    }
+}
+
+/*!
+    \brief Добавление в гистограмму
+    \details Увеличивает на 1 кол-во испытаний со значением статистики value, расширяя гистограмму при
+   необходимости.
+
+    \param[in,out] histogram ссылка на гистограмму.
+    \param[in] value значение статистики.
+
+    \throw std::out_of_range - если value не меньше max_histogram_size.
+*/
+void add_to_histogram(std::vector<std::uint64_t> &histogram, const std::uint64_t value)
+{
+    if (value >= max_histogram_size)
+        throw std::out_of_range("Statistic value is too large!");
+    if (value >= histogram.size())
+        histogram.resize(value + 1, 0);
+    ++histogram[value];
+}
+
+/*!
+    \brief Запуск моделирования
+    \details Делит trials испытаний между threads потоками. Каждый поток получает свой поток случайных чисел, ведёт свою
+   гистограмму и вызывает run_part(испытания, гистограмма). После завершения гистограммы складываются. Если поток не
+   удалось запустить, его испытания выполняет текущий поток. Исключение из любого потока передаётся вызывающему.
+
+    \tparam Part тип функции, моделирующей часть испытаний.
+
+    \param[in] trials кол-во испытаний.
+    \param[in] threads кол-во потоков, 0 - по кол-ву ядер.
+    \param[in] run_part ссылка на функцию, моделирующую часть испытаний.
+
+    \return Результат моделирования.
+*/
+template <typename Part> SimulationResult run_simulation(const std::uint64_t trials, size_t threads, const Part &run_part)
+{
+    if (threads == 0)
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    threads = static_cast<size_t>(std::max<std::uint64_t>(std::min<std::uint64_t>(threads, trials), 1));
+
+    std::vector<std::vector<std::uint64_t>> histograms(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    auto worker = [&histograms, &errors, &run_part, trials, threads](const size_t part)
+    {
+        try
+        {
+            run_part(trials / threads + (part < trials % threads ? 1 : 0), histograms[part]);
+        }
+        catch (...)
+        {
+            errors[part] = std::current_exception();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    size_t started = 1;
+    for (; started < threads; ++started)
+    {
+        try
+        {
+            workers.emplace_back(worker, started);
+        }
+        catch (const std::system_error &)
+        {
+            break;
+        }
+    }
+    worker(0);
+    for (size_t part = started; part < threads; ++part)
+        worker(part);
+    for (std::thread &thread : workers)
+        thread.join();
+
+    SimulationResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (const std::exception_ptr &error : errors)
+        if (error)
+            std::rethrow_exception(error);
+    size_t length = 0;
+    for (const std::vector<std::uint64_t> &histogram : histograms)
+        length = std::max(length, histogram.size());
+    result.histogram = Vector<std::uint64_t>(length, 0);
+    std::uint64_t *merged = result.histogram.get_data();
+    for (const std::vector<std::uint64_t> &histogram : histograms)
+        for (size_t value = 0; value < histogram.size(); ++value)
+            merged[value] += histogram[value];
+    result.trials = trials;
+    result.trials_per_second = result.seconds > 0 ? trials / result.seconds : 0;
+    return result;
+}
+
+/*!
+    \brief Кол-во испытаний в проходе
+    \details Подбирает кол-во испытаний в одном проходе так, чтобы все грани прохода помещались в simulation_block.
+
+    \param[in] size кол-во костей.
+
+    \return Кол-во испытаний в проходе.
+*/
+size_t block_trials(const size_t size)
+{
+    return std::max<size_t>(1, std::min(max_block_trials, simulation_block / std::max<size_t>(size, 1)));
+}
+
+/*!
+    \brief Моделирование суммы
+    \details Бросает группу костей dice trials раз в threads потоках и строит гистограмму суммы значений. Грани
+   генерируются пакетно по столбцам: для каждой кости сразу во всех испытаниях прохода, и складываются в суммы
+   испытаний без создания объектов Dice. Используются только шансы костей, генератор на счётчике группы не
+   используется.
+
+    \param[in] dice ссылка на группу костей.
+    \param[in] trials кол-во испытаний.
+    \param[in] threads кол-во потоков, 0 - по кол-ву ядер.
+
+    \return Результат моделирования, histogram[k] - кол-во испытаний с суммой k.
+
+    \throw std::out_of_range - если сумма может быть не меньше max_histogram_size.
+*/
+SimulationResult simulate_sum(const Dice &dice, const std::uint64_t trials, size_t threads)
+{
+    const size_t size = dice.get_size();
+    if (size * OneDice::faces >= max_histogram_size)
+        throw std::out_of_range("Statistic value is too large!");
+    const OddsHandle *handles = dice.get_odds_handles();
+    return run_simulation(
+        trials, threads,
+        [handles, size](std::uint64_t part_trials, std::vector<std::uint64_t> &histogram)
+        {
+            histogram.assign(size * OneDice::faces + 1, 0);
+            const size_t block = block_trials(size);
+            std::vector<NumPoints> faces(size * block);
+            std::vector<std::uint32_t> sums(block);
+            while (part_trials > 0)
+            {
+                const size_t count = static_cast<size_t>(std::min<std::uint64_t>(part_trials, block));
+                roll_block_faces(handles, size, count, faces.data());
+                std::fill(sums.begin(), sums.begin() + count, 0);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    const NumPoints *column = faces.data() + i * count;
+                    for (size_t t = 0; t < count; ++t)
+                        sums[t] += column[t];
+                }
+                for (size_t t = 0; t < count; ++t)
+                    ++histogram[sums[t]];
+                part_trials -= count;
+            }
+        });
+}
+
+/*!
+    \brief Моделирование статистики
+    \details Бросает группу костей dice trials раз в threads потоках и строит гистограмму значений статистики
+   statistic. Грани генерируются пакетно по столбцам, затем для каждого испытания записываются в копию группы потока,
+   и statistic вызывается для неё. Используются только шансы костей, генератор на счётчике группы не используется.
+
+    \param[in] dice ссылка на группу костей.
+    \param[in] trials кол-во испытаний.
+    \param[in] statistic ссылка на статистику. Вызывается одновременно из нескольких потоков.
+    \param[in] threads кол-во потоков, 0 - по кол-ву ядер.
+
+    \return Результат моделирования, histogram[k] - кол-во испытаний со статистикой k.
+
+    \throw std::out_of_range - если значение статистики не меньше max_histogram_size.
+*/
+SimulationResult simulate(const Dice &dice, const std::uint64_t trials, const DiceStatistic &statistic,
+                          size_t threads)
+{
+    const size_t size = dice.get_size();
+    return run_simulation(
+        trials, threads,
+        [&dice, &statistic, size](std::uint64_t part_trials, std::vector<std::uint64_t> &histogram)
+        {
+            Dice trial = dice;
+            const size_t block = block_trials(size);
+            std::vector<NumPoints> faces(size * block);
+            std::vector<PackedNumPoints> row(size);
+            while (part_trials > 0)
+            {
+                const size_t count = static_cast<size_t>(std::min<std::uint64_t>(part_trials, block));
+                roll_block_faces(trial.get_odds_handles(), size, count, faces.data());
+                for (size_t t = 0; t < count; ++t)
+                {
+                    for (size_t i = 0; i < size; ++i)
+                        row[i] = static_cast<PackedNumPoints>(faces[i * count + t]);
+                    trial.set_values(row.data(), row.data() + size);
+                    add_to_histogram(histogram, statistic(trial));
+                }
+                part_trials -= count;
+            }
+        });
+}
+
+/*! @} */
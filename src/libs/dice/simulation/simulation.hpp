@@ -0,0 +1,40 @@
+/*!
+    \defgroup Simulation_submodule Моделирование бросков
+    \ingroup Dice_module
+    \brief Многопоточное моделирование бросков группы костей методом Монте-Карло
+*/
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+/*!
+    \addtogroup Simulation_submodule
+    @{
+*/
+
+#include <functional>
+
+#include "../dice.hpp"
+
+constexpr size_t max_histogram_size = size_t(1) << 24; ///< Максимальное значение статистики + 1
+
+typedef std::function<std::uint64_t(const Dice &)> DiceStatistic; ///< Статистика броска группы костей
+
+/*!
+    \brief Результат моделирования
+    \details Гистограмма значений статистики по всем испытаниям и скорость моделирования.
+*/
+struct SimulationResult
+{
+        Vector<std::uint64_t> histogram; ///< Кол-во испытаний с каждым значением статистики
+        std::uint64_t trials = 0;             ///< Кол-во испытаний
+        double seconds = 0;                   ///< Время моделирования в секундах
+        double trials_per_second = 0;         ///< Кол-во испытаний в секунду
+};
+
+SimulationResult simulate_sum(const Dice &dice, const std::uint64_t trials, size_t threads = 0);
+SimulationResult simulate(const Dice &dice, const std::uint64_t trials, const DiceStatistic &statistic,
+                          size_t threads = 0);
+
+/*! @} */
+
+#endif // SIMULATION_HPP
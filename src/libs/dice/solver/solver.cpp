@@ -0,0 +1,391 @@
+#include "solver.hpp"
+
+/*!
+    \addtogroup Solver_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+constexpr std::uint16_t no_state = std::numeric_limits<std::uint16_t>::max(); ///< Номер сигнатуры вне таблиц
+constexpr double value_tolerance = 1e-12; ///< Разница ожидаемых очков, при которой решения считаются равными
+
+/*!
+    \brief Разбор сигнатуры
+    \details Записывает кол-во костей с каждым значением.
+
+    \param[in] signature сигнатура группы.
+    \param[out] counts указатель на кол-ва костей со значениями 1..OneDice::faces.
+
+    \return Кол-во костей в группе.
+*/
+static size_t decode_signature(FaceSignature signature, size_t *counts) noexcept
+{
+    size_t total = 0;
+    for (size_t face = 1; face <= OneDice::faces; ++face, signature /= signature_base)
+    {
+        counts[face] = signature % signature_base;
+        total += counts[face];
+    }
+    return total;
+}
+
+/*!
+    \brief Вес значения в сигнатуре
+    \param[in] face значение кости.
+
+    \return signature_base^(face - 1).
+*/
+static FaceSignature face_weight(const size_t face) noexcept
+{
+    FaceSignature weight = 1;
+    for (size_t i = 1; i < face; ++i)
+        weight *= signature_base;
+    return weight;
+}
+
+/*!
+    \brief Параллельный цикл
+    \details Делит номера 0..count - 1 на threads равных частей и вызывает body для каждой части в своём потоке. Если
+   поток не удалось создать, его часть выполняет вызывающий поток.
+
+    \param[in] count кол-во номеров.
+    \param[in] threads кол-во потоков.
+    \param[in] body ссылка на функцию, обрабатывающую номера first..last - 1.
+*/
+template <typename Body> static void parallel_for(const size_t count, const size_t threads, const Body &body)
+{
+    const size_t parts = std::max<size_t>(std::min(threads, count), 1);
+    const size_t part_size = (count + parts - 1) / parts;
+    std::vector<std::thread> workers;
+    size_t started = 1;
+    for (; started < parts; ++started)
+    {
+        try
+        {
+            workers.emplace_back(body, started * part_size, std::min(count, (started + 1) * part_size));
+        }
+        catch (const std::system_error &)
+        {
+            break;
+        }
+    }
+    body(0, std::min(count, part_size));
+    body(std::min(count, started * part_size), count);
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+/*!
+    \brief Конструктор с комбинацией
+    \details Создаёт решатель, максимизирующий очки комбинации pattern.
+
+    \param[in] dice_count кол-во костей в группе.
+    \param[in] rolls максимальное кол-во перебросов.
+    \param[in] pattern комбинация.
+    \param[in] odds ссылка на шансы выпадения граней всех костей.
+    \param[in] threads кол-во потоков для заполнения таблиц, 0 - по числу ядер.
+
+    \throw std::length_error - если dice_count больше max_pattern_dice.
+*/
+RerollSolver::RerollSolver(const size_t dice_count, const unsigned rolls, const Pattern pattern, const Odds &odds,
+                           const size_t threads)
+    : RerollSolver(
+          dice_count, rolls, [pattern](const FaceSignature signature)
+          { return static_cast<double>(score_Pattern(signature, pattern)); }, odds, threads)
+{
+}
+
+/*!
+    \brief Конструктор с функцией очков
+    \details Создаёт решатель, максимизирующий score. Функция вызывается из вызывающего потока один раз для каждой
+   группы из dice_count костей.
+
+    \param[in] dice_count кол-во костей в группе.
+    \param[in] rolls максимальное кол-во перебросов.
+    \param[in] score ссылка на функцию очков группы.
+    \param[in] odds ссылка на шансы выпадения граней всех костей.
+    \param[in] threads кол-во потоков для заполнения таблиц, 0 - по числу ядер.
+
+    \throw std::length_error - если dice_count больше max_pattern_dice.
+*/
+RerollSolver::RerollSolver(const size_t dice_count, const unsigned rolls, const SignatureScore &score,
+                           const Odds &odds, const size_t threads)
+    : dice_count(dice_count), rolls(rolls)
+{
+    if (dice_count > max_pattern_dice)
+        throw std::length_error("Too many dice for reroll solver!");
+    build(score, odds, threads);
+}
+
+/*!
+    \brief Заполнение таблиц
+    \details Перечисляет все мультимножества до dice_count значений и исходы броска m костей с их вероятностями.
+   Затем для каждого кол-ва оставшихся перебросов r вычисляет ожидаемые очки каждого оставляемого мультимножества
+   K: сумму по исходам R броска dice_count - |K| костей вероятности R на значение группы K + R при r - 1 перебросах.
+   Значение группы равно максимуму по её подмультимножествам. Оба шага каждого уровня делятся между потоками.
+
+    \param[in] score ссылка на функцию очков группы.
+    \param[in] odds ссылка на шансы выпадения граней всех костей.
+    \param[in] threads кол-во потоков, 0 - по числу ядер.
+*/
+void RerollSolver::build(const SignatureScore &score, const Odds &odds, size_t threads)
+{
+    if (threads == 0)
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    odds_handle = OddsRegistry<OneDice::faces>::intern(odds);
+
+    state_index = Vector<std::uint16_t>(signature_count, no_state);
+    std::vector<size_t> state_sizes;
+    for (FaceSignature signature = 0; signature < signature_count; ++signature)
+    {
+        size_t counts[OneDice::faces + 1];
+        size_t size = decode_signature(signature, counts);
+        if (size <= dice_count)
+        {
+            state_index.get_data()[signature] = static_cast<std::uint16_t>(states.get_size());
+            states.push_back(signature);
+            state_sizes.push_back(size);
+        }
+    }
+
+    double probability[OneDice::faces + 1] = {};
+    double total = 0;
+    for (size_t face = 1; face <= OneDice::faces; ++face)
+        total += odds.get_odds(face - 1);
+    for (size_t face = 1; face <= OneDice::faces; ++face)
+        probability[face] = odds.get_odds(face - 1) / total;
+    double factorial[max_pattern_dice + 1] = {1};
+    for (size_t i = 1; i <= max_pattern_dice; ++i)
+        factorial[i] = factorial[i - 1] * static_cast<double>(i);
+
+    const size_t state_count = states.get_size();
+    const FaceSignature *signatures = states.get_data();
+    const std::uint16_t *index = state_index.get_data();
+    std::vector<std::vector<std::pair<FaceSignature, double>>> outcomes(dice_count + 1);
+    for (size_t state = 0; state < state_count; ++state)
+    {
+        size_t counts[OneDice::faces + 1];
+        decode_signature(signatures[state], counts);
+        double p = factorial[state_sizes[state]];
+        for (size_t face = 1; face <= OneDice::faces; ++face)
+            for (size_t i = 0; i < counts[face]; ++i)
+                p *= probability[face] / static_cast<double>(i + 1);
+        if (p > 0)
+            outcomes[state_sizes[state]].emplace_back(signatures[state], p);
+    }
+
+    values = Vector<Vector<double>>(rolls + 1, Vector<double>(state_count, 0.0));
+    keep_values = Vector<Vector<double>>(rolls + 1, Vector<double>(state_count, 0.0));
+    double *initial = values.get_data()[0].get_data();
+    for (size_t state = 0; state < state_count; ++state)
+        if (state_sizes[state] == dice_count)
+            initial[state] = score(signatures[state]);
+
+    for (unsigned r = 1; r <= rolls; ++r)
+    {
+        const double *previous = values.get_data()[r - 1].get_data();
+        double *keep = keep_values.get_data()[r].get_data();
+        parallel_for(state_count, threads,
+                     [this, previous, keep, signatures, index, &outcomes, &state_sizes](const size_t first,
+                                                                                         const size_t last)
+                     {
+                         for (size_t state = first; state < last; ++state)
+                         {
+                             double expected = 0;
+                             for (const std::pair<FaceSignature, double> &outcome :
+                                  outcomes[dice_count - state_sizes[state]])
+                                 expected += outcome.second * previous[index[signatures[state] + outcome.first]];
+                             keep[state] = expected;
+                         }
+                     });
+        double *current = values.get_data()[r].get_data();
+        parallel_for(state_count, threads,
+                     [this, current, signatures, &state_sizes, r](const size_t first, const size_t last)
+                     {
+                         FaceSignature keep;
+                         for (size_t state = first; state < last; ++state)
+                             if (state_sizes[state] == dice_count)
+                                 current[state] = best_keep(signatures[state], r, keep);
+                     });
+    }
+}
+
+/*!
+    \brief Выбор оставляемых костей
+    \details Перебирает все подмультимножества группы signature в смешанной системе счисления, меняя сигнатуру
+   подмультимножества на вес одного значения за шаг, и выбирает подмультимножество с наибольшими ожидаемыми очками.
+   При равных очках выбирается то, в котором больше костей.
+
+    \param[in] signature сигнатура группы.
+    \param[in] rolls_left кол-во оставшихся перебросов, не меньше 1.
+    \param[out] keep ссылка на сигнатуру лучшего подмультимножества.
+
+    \return Ожидаемые очки при оставлении keep.
+*/
+double RerollSolver::best_keep(const FaceSignature signature, const unsigned rolls_left, FaceSignature &keep) const
+    noexcept
+{
+    const double *keep_value = keep_values.get_data()[rolls_left].get_data();
+    const std::uint16_t *index = state_index.get_data();
+    size_t counts[OneDice::faces + 1], kept[OneDice::faces + 1] = {};
+    decode_signature(signature, counts);
+    FaceSignature weights[OneDice::faces + 1];
+    for (size_t face = 1; face <= OneDice::faces; ++face)
+        weights[face] = face_weight(face);
+
+    FaceSignature current = 0;
+    size_t current_size = 0, best_size = 0;
+    double best = keep_value[index[0]];
+    keep = 0;
+    while (true)
+    {
+        size_t face = 1;
+        while (face <= OneDice::faces && kept[face] == counts[face])
+        {
+            current -= static_cast<FaceSignature>(kept[face]) * weights[face];
+            current_size -= kept[face];
+            kept[face++] = 0;
+        }
+        if (face > OneDice::faces)
+            break;
+        ++kept[face];
+        current += weights[face];
+        ++current_size;
+        double value = keep_value[index[current]];
+        if (value > best + value_tolerance || (value > best - value_tolerance && current_size > best_size))
+        {
+            best = value;
+            best_size = current_size;
+            keep = current;
+        }
+    }
+    return best;
+}
+
+/*!
+    \brief Геттер кол-ва костей
+    \return Кол-во костей в группе.
+*/
+size_t RerollSolver::get_dice_count() const noexcept
+{
+    return dice_count;
+}
+
+/*!
+    \brief Геттер кол-ва перебросов
+    \return Максимальное кол-во перебросов.
+*/
+unsigned RerollSolver::get_rolls() const noexcept
+{
+    return rolls;
+}
+
+/*!
+    \brief Проверка группы
+    \details Проверяет, что signature - сигнатура группы из dice_count костей, а rolls_left не больше rolls.
+
+    \param[in] signature сигнатура группы.
+    \param[in] rolls_left кол-во оставшихся перебросов.
+
+    \return Номер группы в таблицах.
+
+    \throw std::invalid_argument - если signature не является сигнатурой группы из dice_count костей.
+    \throw std::out_of_range - если rolls_left больше rolls.
+*/
+size_t RerollSolver::find_state(const FaceSignature signature, const unsigned rolls_left) const
+{
+    size_t counts[OneDice::faces + 1];
+    if (signature >= signature_count || decode_signature(signature, counts) != dice_count)
+        throw std::invalid_argument("Signature does not match dice count!");
+    if (rolls_left > rolls)
+        throw std::out_of_range("Too many rolls left!");
+    return state_index[signature];
+}
+
+/*!
+    \brief Ожидаемые очки
+    \details Работает за O(1) по таблице.
+
+    \param[in] signature сигнатура группы.
+    \param[in] rolls_left кол-во оставшихся перебросов.
+
+    \return Ожидаемые очки группы при оптимальной игре.
+
+    \throw std::invalid_argument - если signature не является сигнатурой группы из dice_count костей.
+    \throw std::out_of_range - если rolls_left больше rolls.
+*/
+double RerollSolver::get_value(const FaceSignature signature, const unsigned rolls_left) const
+{
+    size_t state = find_state(signature, rolls_left);
+    return values.get_data()[rolls_left].get_data()[state];
+}
+
+/*!
+    \brief Решение для сигнатуры
+    \details Перебирает подмультимножества группы, то есть не больше 2^dice_count обращений к таблице. Без
+   оставшихся перебросов оставляются все кости. Поле reroll не заполняется.
+
+    \param[in] signature сигнатура группы.
+    \param[in] rolls_left кол-во оставшихся перебросов.
+
+    \return Лучшее оставляемое мультимножество и ожидаемые очки.
+
+    \throw std::invalid_argument - если signature не является сигнатурой группы из dice_count костей.
+    \throw std::out_of_range - если rolls_left больше rolls.
+*/
+RerollDecision RerollSolver::solve(const FaceSignature signature, const unsigned rolls_left) const
+{
+    size_t state = find_state(signature, rolls_left);
+    RerollDecision decision;
+    if (rolls_left == 0)
+    {
+        decision.keep = signature;
+        decision.expected = values.get_data()[0].get_data()[state];
+    }
+    else
+        decision.expected = best_keep(signature, rolls_left, decision.keep);
+    return decision;
+}
+
+/*!
+    \brief Решение для группы
+    \details Находит решение для сигнатуры группы и переводит его в номера перебрасываемых костей: оставляются первые
+   по порядку кости с нужными значениями. Номера подходят для Dice::reroll.
+
+    \param[in] dice ссылка на группу костей.
+    \param[in] rolls_left кол-во оставшихся перебросов.
+
+    \return Решение с номерами перебрасываемых костей.
+
+    \throw std::invalid_argument - если в группе не dice_count костей или шансы какой-либо кости отличаются от шансов
+   решателя.
+    \throw std::out_of_range - если rolls_left больше rolls.
+*/
+RerollDecision RerollSolver::solve(const Dice &dice, const unsigned rolls_left) const
+{
+    if (dice.get_size() != dice_count)
+        throw std::invalid_argument("Signature does not match dice count!");
+    const OddsHandle *handles = dice.get_odds_handles();
+    if (std::any_of(handles, handles + dice_count, [this](const OddsHandle handle) { return handle != odds_handle; }))
+        throw std::invalid_argument("Dice odds differ from solver odds!");
+    RerollDecision decision = solve(to_FaceSignature(dice), rolls_left);
+    size_t kept[OneDice::faces + 1];
+    decode_signature(decision.keep, kept);
+    const PackedNumPoints *value = dice.get_values();
+    for (size_t i = 0; i < dice_count; ++i)
+    {
+        if (kept[value[i]] > 0)
+            --kept[value[i]];
+        else
+            decision.reroll.push_back(i);
+    }
+    return decision;
+}
+
+/*! @} */
@@ -0,0 +1,70 @@
+/*!
+    \defgroup Solver_submodule Выбор перебрасываемых костей
+    \ingroup Dice_module
+    \brief Оптимальная стратегия перебросов по ожидаемым очкам
+*/
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+/*!
+    \addtogroup Solver_submodule
+    @{
+*/
+
+#include <functional>
+
+#include "../scoring/scoring.hpp"
+
+typedef std::function<double(const FaceSignature)> SignatureScore; ///< Очки группы по её сигнатуре
+
+/*!
+    \brief Решение о перебросе
+    \details Какие кости оставить, какие перебросить и сколько очков в среднем принесёт оптимальная игра после этого.
+*/
+struct RerollDecision
+{
+        FaceSignature keep = 0;      ///< Сигнатура оставляемых костей
+        Vector<size_t> reroll;       ///< Номера перебрасываемых костей в группе
+        double expected = 0;         ///< Ожидаемые очки
+};
+
+/*!
+    \brief Класс решателя перебросов
+    \details Объект RerollSolver заранее вычисляет ожидаемые очки оптимальной игры (expectimax) для всех групп из
+   dice_count костей с одинаковыми шансами и до rolls оставшихся перебросов. Состояние - мультимножество значений,
+   записанное сигнатурой, поэтому группы, отличающиеся порядком костей, считаются один раз. Для каждого оставляемого
+   мультимножества ожидание по всем исходам переброса вычисляется один раз и используется всеми группами, которые его
+   содержат. Таблицы заполняются параллельно, после чего запрос перебирает только подмультимножества группы.
+*/
+class RerollSolver
+{
+    private:
+        size_t dice_count = 0;
+        unsigned rolls = 0;
+        OddsHandle odds_handle = fair_odds_handle;
+        Vector<FaceSignature> states;
+        Vector<std::uint16_t> state_index;
+        Vector<Vector<double>> values;
+        Vector<Vector<double>> keep_values;
+
+        void build(const SignatureScore &score, const Odds &odds, size_t threads);
+        double best_keep(const FaceSignature signature, const unsigned rolls_left, FaceSignature &keep) const noexcept;
+        size_t find_state(const FaceSignature signature, const unsigned rolls_left) const;
+
+    public:
+        RerollSolver(const size_t dice_count, const unsigned rolls, const Pattern pattern, const Odds &odds = Odds(),
+                     const size_t threads = 0);
+        RerollSolver(const size_t dice_count, const unsigned rolls, const SignatureScore &score,
+                     const Odds &odds = Odds(), const size_t threads = 0);
+
+        size_t get_dice_count() const noexcept;
+        unsigned get_rolls() const noexcept;
+
+        double get_value(const FaceSignature signature, const unsigned rolls_left) const;
+        RerollDecision solve(const FaceSignature signature, const unsigned rolls_left) const;
+        RerollDecision solve(const Dice &dice, const unsigned rolls_left) const;
+};
+
+/*! @} */
+
+#endif // SOLVER_HPP
@@ -0,0 +1,338 @@
+#include "storage.hpp"
+
+/*!
+    \addtogroup Storage_submodule
+    @{
+*/
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+/*!
+    \brief Выравнивание смещения
+    \details Округляет offset вверх до кратного dice_file_alignment.
+
+    \param[in] offset смещение в файле.
+
+    \return Выравненное смещение.
+*/
+static std::uint64_t align_offset(const std::uint64_t offset) noexcept
+{
+    return (offset + dice_file_alignment - 1) / dice_file_alignment * dice_file_alignment;
+}
+
+/*!
+    \brief Запись раздела файла
+    \details Дополняет файл нулями до offset и записывает size байт из data.
+
+    \param[in] output ссылка на поток файла.
+    \param[in] position ссылка на текущую позицию в файле.
+    \param[in] offset смещение раздела.
+    \param[in] data указатель на данные раздела.
+    \param[in] size размер раздела в байтах.
+*/
+static void write_section(std::ofstream &output, std::uint64_t &position, const std::uint64_t offset,
+                          const void *data, const size_t size)
+{
+    static const char padding[dice_file_alignment] = {};
+    output.write(padding, static_cast<std::streamsize>(offset - position));
+    output.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+    position = offset + size;
+}
+
+/*!
+    \brief Сохранение группы костей в файл
+    \details Записывает группу костей dice в двоичный файл path. Номера шансов реестра заменяются номерами в таблице
+   шансов файла, поэтому файл не зависит от реестра процесса. Если все кости "честные", массив номеров шансов не
+   записывается.
+
+    \param[in] dice ссылка на группу костей.
+    \param[in] path ссылка на путь к файлу.
+
+    \throw std::system_error - если файл не удалось записать.
+    \throw std::length_error - если в группе больше различных шансов, чем помещается в номер таблицы.
+*/
+void save_Dice(const Dice &dice, const std::string &path)
+{
+    size_t size = dice.get_size();
+    const PackedNumPoints *values = dice.get_values();
+    const OddsHandle *handles = dice.get_odds_handles();
+
+    std::unordered_map<OddsHandle, std::uint16_t> file_indices;
+    std::vector<Chance> odds_table;
+    std::vector<std::uint16_t> odds_indices(size);
+    bool has_odds = false;
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto found = file_indices.find(handles[i]);
+        if (found == file_indices.end())
+        {
+            if (file_indices.size() > std::numeric_limits<std::uint16_t>::max())
+                throw std::length_error("Too many different odds!");
+            found = file_indices.emplace(handles[i], static_cast<std::uint16_t>(file_indices.size())).first;
+            const Odds &odds = OddsRegistry<OneDice::faces>::get_odds(handles[i]);
+            for (size_t face = 0; face < OneDice::faces; ++face)
+                odds_table.push_back(odds.get_odds(face));
+        }
+        odds_indices[i] = found->second;
+        has_odds = has_odds || handles[i] != fair_odds_handle;
+    }
+
+    DiceFileHeader header = {};
+    std::memcpy(header.magic, dice_file_magic, sizeof(header.magic));
+    header.version = dice_file_version;
+    header.byte_order = dice_file_byte_order;
+    header.faces = OneDice::faces;
+    header.flags = has_odds ? dice_file_has_odds : 0;
+    header.count = size;
+    header.odds_count = file_indices.size();
+    header.odds_offset = align_offset(sizeof(DiceFileHeader));
+    header.handles_offset = align_offset(header.odds_offset + odds_table.size() * sizeof(Chance));
+    header.values_offset = has_odds ? align_offset(header.handles_offset + size * sizeof(std::uint16_t))
+                                    : header.handles_offset;
+    for (NumPoints face = 1; face <= OneDice::faces; ++face)
+        header.counts[face] = dice.count_NumPoints(face);
+    header.sum = dice.sum();
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output)
+        throw std::system_error(std::make_error_code(std::errc::io_error), path);
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    std::uint64_t position = sizeof(header);
+    write_section(output, position, header.odds_offset, odds_table.data(), odds_table.size() * sizeof(Chance));
+    if (has_odds)
+        write_section(output, position, header.handles_offset, odds_indices.data(),
+                      size * sizeof(std::uint16_t));
+    write_section(output, position, header.values_offset, values, size * sizeof(PackedNumPoints));
+    output.flush();
+    if (!output)
+        throw std::system_error(std::make_error_code(std::errc::io_error), path);
+}
+
+/*!
+    \brief Проверка раздела файла
+    \details Проверяет, что раздел из count элементов по element байт, начинающийся со смещения offset, выровнен и
+   помещается в файл размера file_size.
+
+    \param[in] offset смещение раздела.
+    \param[in] count кол-во элементов раздела.
+    \param[in] element размер элемента в байтах.
+    \param[in] file_size размер файла в байтах.
+
+    \return True если раздел корректен. Иначе False.
+*/
+static bool check_section(const std::uint64_t offset, const std::uint64_t count, const size_t element,
+                          const size_t file_size) noexcept
+{
+    return offset % element == 0 && offset <= file_size && count <= (file_size - offset) / element;
+}
+
+/*!
+    \brief Конструктор с путём к файлу
+    \details Отображает файл path в память и проверяет заголовок и границы разделов. Значения костей не читаются и не
+   копируются.
+
+    \param[in] path ссылка на путь к файлу.
+
+    \throw std::system_error - если файл не удалось открыть или отобразить.
+    \throw std::invalid_argument - если файл не является файлом группы костей этой версии или повреждён.
+*/
+DiceView::DiceView(const std::string &path) : file(path)
+{
+    if (file.get_size() < sizeof(DiceFileHeader))
+        throw std::invalid_argument("Invalid dice file!");
+    header = reinterpret_cast<const DiceFileHeader *>(file.get_data());
+    if (std::memcmp(header->magic, dice_file_magic, sizeof(header->magic)) != 0)
+        throw std::invalid_argument("Invalid dice file!");
+    if (header->version != dice_file_version)
+        throw std::invalid_argument("Unsupported dice file version!");
+    if (header->byte_order != dice_file_byte_order)
+        throw std::invalid_argument("Unsupported dice file byte order!");
+    if (header->faces != OneDice::faces)
+        throw std::invalid_argument("Unsupported number of faces!");
+
+    size_t file_size = file.get_size();
+    bool has_odds = (header->flags & dice_file_has_odds) != 0;
+    if ((header->odds_count == 0 && header->count != 0) || header->odds_count > std::numeric_limits<std::uint16_t>::max() + size_t(1) ||
+        !check_section(header->odds_offset, header->odds_count * OneDice::faces, sizeof(Chance), file_size) ||
+        (has_odds && !check_section(header->handles_offset, header->count, sizeof(std::uint16_t), file_size)) ||
+        !check_section(header->values_offset, header->count, sizeof(PackedNumPoints), file_size))
+        throw std::invalid_argument("Corrupted dice file!");
+    std::uint64_t count = 0, total = 0;
+    for (NumPoints face = 1; face <= OneDice::faces; ++face)
+    {
+        count += header->counts[face];
+        total += header->counts[face] * face;
+    }
+    if (header->counts[0] != 0 || count != header->count || total != header->sum)
+        throw std::invalid_argument("Corrupted dice file!");
+
+    odds_table = reinterpret_cast<const Chance *>(file.get_data() + header->odds_offset);
+    if (has_odds)
+        odds_indices = reinterpret_cast<const std::uint16_t *>(file.get_data() + header->handles_offset);
+    values = reinterpret_cast<const PackedNumPoints *>(file.get_data() + header->values_offset);
+}
+
+/*!
+    \brief Проверка значений
+    \details Читает все значения и номера шансов и сверяет их с заголовком. Работает за O(n), поэтому не выполняется
+   при открытии файла.
+
+    \throw std::invalid_argument - если значение или номер шансов повреждены или не совпадают с заголовком.
+*/
+void DiceView::verify() const
+{
+    size_t size = get_size();
+    std::uint64_t counts[OneDice::faces + 1] = {};
+    for (size_t i = 0; i < size; ++i)
+        ++counts[values[i] <= OneDice::faces ? values[i] : 0];
+    for (NumPoints face = 0; face <= OneDice::faces; ++face)
+        if (counts[face] != header->counts[face])
+            throw std::invalid_argument("Corrupted dice file!");
+    if (odds_indices != nullptr)
+        for (size_t i = 0; i < size; ++i)
+            if (odds_indices[i] >= header->odds_count)
+                throw std::invalid_argument("Corrupted dice file!");
+}
+
+/*!
+    \brief Геттер размера группы
+    \return Кол-во костей в файле.
+*/
+size_t DiceView::get_size() const noexcept
+{
+    return static_cast<size_t>(header->count);
+}
+
+/*!
+    \brief Геттер массива значений
+    \details Возвращает указатель на значения костей прямо в отображении файла.
+
+    \return Указатель на первое значение.
+*/
+const PackedNumPoints *DiceView::get_values() const noexcept
+{
+    return values;
+}
+
+/*!
+    \brief Геттер значения кости
+    \param[in] index номер кости.
+
+    \return Значение кости.
+
+    \throw std::out_of_range - если номер кости больше или равен кол-ву костей.
+    \throw std::invalid_argument - если значение в файле повреждено.
+*/
+NumPoints DiceView::get_value(const size_t index) const
+{
+    if (index >= get_size())
+        throw std::out_of_range("Index out of range!");
+    NumPoints value = values[index];
+    if (value == 0 || value > OneDice::faces)
+        throw std::invalid_argument("Corrupted dice file!");
+    return value;
+}
+
+/*!
+    \brief Геттер шансов кости
+    \param[in] index номер кости.
+
+    \return Шансы выпадения граней кости.
+
+    \throw std::out_of_range - если номер кости больше или равен кол-ву костей.
+    \throw std::invalid_argument - если номер шансов в файле повреждён.
+*/
+Odds DiceView::get_odds(const size_t index) const
+{
+    if (index >= get_size())
+        throw std::out_of_range("Index out of range!");
+    std::uint16_t odds_index = odds_indices == nullptr ? 0 : odds_indices[index];
+    if (odds_index >= header->odds_count)
+        throw std::invalid_argument("Corrupted dice file!");
+    return Odds(odds_table + odds_index * OneDice::faces);
+}
+
+/*!
+    \brief Проверка на наличие значения
+    \details Работает за O(1) по кол-вам значений из заголовка без сверки со значениями.
+
+    \param[in] value значение.
+
+    \return True если в файле есть кость со значением value. Иначе False.
+*/
+bool DiceView::has_NumPoints(const NumPoints value) const
+{
+    return count_NumPoints(value) != 0;
+}
+
+/*!
+    \brief Подсчёт костей со значением
+    \details Работает за O(1) по кол-вам значений из заголовка без сверки со значениями.
+
+    \param[in] value значение.
+
+    \return Кол-во костей со значением value.
+*/
+size_t DiceView::count_NumPoints(const NumPoints value) const
+{
+    if (value == 0 || value > OneDice::faces)
+        return 0;
+    return static_cast<size_t>(header->counts[value]);
+}
+
+/*!
+    \brief Сумма значений
+    \details Работает за O(1) по сумме из заголовка без сверки со значениями.
+
+    \return Сумма значений всех костей в файле.
+*/
+std::uint64_t DiceView::sum() const noexcept
+{
+    return header->sum;
+}
+
+/*!
+    \brief Загрузка группы костей
+    \details Сверяет файл с заголовком через verify() и копирует кости в объект Dice. Шансы из таблицы файла заносятся
+   в реестр один раз на запись таблицы.
+
+    \return Группа костей из файла.
+
+    \throw std::invalid_argument - если значения или номера шансов в файле повреждены или не совпадают с заголовком.
+*/
+Dice DiceView::to_Dice() const
+{
+    verify();
+    size_t size = get_size();
+    Dice dice(values, values + size);
+    if (odds_indices != nullptr)
+    {
+        std::vector<OddsHandle> handles(static_cast<size_t>(header->odds_count));
+        for (size_t i = 0; i < handles.size(); ++i)
+            handles[i] = OddsRegistry<OneDice::faces>::intern(Odds(odds_table + i * OneDice::faces));
+        for (size_t i = 0; i < size; ++i)
+            dice[i].set_odds_handle(handles[odds_indices[i]]);
+    }
+    return dice;
+}
+
+/*!
+    \brief Перегрузка оператора []
+    \param[in] index номер кости.
+
+    \return Копия кости из файла.
+
+    \throw std::out_of_range - если номер кости больше или равен кол-ву костей.
+    \throw std::invalid_argument - если кость в файле повреждена.
+*/
+OneDice DiceView::operator[](const size_t index) const
+{
+    return OneDice(get_value(index), get_odds(index));
+}
+
+/*! @} */
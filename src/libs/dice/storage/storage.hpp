@@ -0,0 +1,86 @@
+/*!
+    \defgroup Storage_submodule Двоичный формат
+    \ingroup Dice_module
+    \brief Сохранение групп костей в двоичный файл и чтение без копирования
+*/
+#ifndef STORAGE_HPP
+#define STORAGE_HPP
+
+/*!
+    \addtogroup Storage_submodule
+    @{
+*/
+
+#include <string>
+
+#include "../dice.hpp"
+#include "../mapped/mapped.hpp"
+
+constexpr char dice_file_magic[8] = {'D', 'I', 'C', 'E', 'B', 'I', 'N', '\0'}; ///< Сигнатура файла
+constexpr std::uint32_t dice_file_version = 1;                                   ///< Версия формата
+constexpr std::uint32_t dice_file_byte_order = 0x01020304;                       ///< Метка порядка байт
+constexpr std::uint32_t dice_file_has_odds = 1;     ///< Флаг наличия массива номеров шансов
+constexpr size_t dice_file_alignment = 64;          ///< Выравнивание разделов файла
+
+/*!
+    \brief Заголовок файла группы костей
+    \details Файл состоит из заголовка, таблицы шансов (odds_count записей по faces значений Chance), массива номеров
+   шансов в таблице (std::uint16_t на кость, только при флаге dice_file_has_odds, иначе все кости "честные") и
+   плотного массива значений (PackedNumPoints на кость). Разделы выровнены по dice_file_alignment байт. Числа
+   записываются в порядке байт машины, который проверяется по метке byte_order.
+*/
+struct DiceFileHeader
+{
+        char magic[8];                                 ///< Сигнатура dice_file_magic
+        std::uint32_t version;                         ///< Версия формата
+        std::uint32_t byte_order;                      ///< Метка порядка байт dice_file_byte_order
+        std::uint32_t faces;                           ///< Кол-во граней костей
+        std::uint32_t flags;                           ///< Флаги формата
+        std::uint64_t count;                           ///< Кол-во костей
+        std::uint64_t odds_count;                      ///< Кол-во записей в таблице шансов
+        std::uint64_t odds_offset;                     ///< Смещение таблицы шансов
+        std::uint64_t handles_offset;                  ///< Смещение массива номеров шансов
+        std::uint64_t values_offset;                   ///< Смещение массива значений
+        std::uint64_t counts[OneDice::faces + 1];      ///< Кол-во костей с каждым значением
+        std::uint64_t sum;                             ///< Сумма значений
+};
+
+void save_Dice(const Dice &dice, const std::string &path);
+
+/*!
+    \brief Класс группы костей в файле
+    \details Объект DiceView отображает файл группы костей в память и читает кости прямо из отображения без копирования.
+   Сумма и кол-во костей с каждым значением берутся из заголовка, которому объект доверяет: при открытии заголовок
+   сверяется только сам с собой. Согласованность заголовка со значениями проверяет verify().
+*/
+class DiceView
+{
+    private:
+        MappedFile file;
+        const DiceFileHeader *header = nullptr;
+        const Chance *odds_table = nullptr;
+        const std::uint16_t *odds_indices = nullptr;
+        const PackedNumPoints *values = nullptr;
+
+    public:
+        DiceView(const std::string &path);
+
+        void verify() const;
+
+        size_t get_size() const noexcept;
+        const PackedNumPoints *get_values() const noexcept;
+        NumPoints get_value(const size_t index) const;
+        Odds get_odds(const size_t index) const;
+
+        bool has_NumPoints(const NumPoints value) const;
+        size_t count_NumPoints(const NumPoints value) const;
+        std::uint64_t sum() const noexcept;
+
+        Dice to_Dice() const;
+
+        OneDice operator[](const size_t index) const;
+};
+
+/*! @} */
+
+#endif // STORAGE_HPP
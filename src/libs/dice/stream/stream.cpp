@@ -0,0 +1,630 @@
+#include "stream.hpp"
+
+/*!
+    \addtogroup Stream_submodule
+    @{
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "../journal/journal.hpp"
+
+/*!
+    \brief Запись пачки в журнал
+    \details Записывает броски отдельной кости в журнал бросков, если он включён.
+
+    \param[in] values указатель на значения.
+    \param[in] count кол-во значений.
+    \param[in] faces кол-во граней кости.
+*/
+static void journal_batch(const NumPoints *values, const size_t count, const NumPoints faces)
+{
+    if (!is_roll_journal_active())
+        return;
+    for (size_t i = 0; i < count; ++i)
+        journal_roll(journal_no_index, values[i], faces);
+}
+
+/*!
+    \brief Поток бросков кости
+    \details Лениво выдаёт count бросков кости с шансами dice. Броски генерируются пачками по stream_batch в буфере
+   сопрограммы, поэтому на одно значение не приходится отдельного обращения к генератору. Сама кость не меняется.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] dice ссылка на кость, шансы которой используются.
+    \param[in] count кол-во бросков, stream_unlimited - бесконечно.
+
+    \return Генератор значений.
+*/
+template <size_t Faces> RollGenerator<NumPoints> roll_stream(const BasicOneDice<Faces> &dice, const std::uint64_t count)
+{
+    const OddsHandle handle = dice.get_odds_handle();
+    std::vector<NumPoints> buffer(stream_batch);
+    for (std::uint64_t left = count; left > 0;)
+    {
+        size_t size = static_cast<size_t>(std::min<std::uint64_t>(left, stream_batch));
+        random_odds<Faces>(handle, buffer.data(), size);
+        journal_batch(buffer.data(), size, Faces);
+        for (size_t i = 0; i < size; ++i)
+            co_yield buffer[i];
+        if (left != stream_unlimited)
+            left -= size;
+    }
+}
+
+/*!
+    \brief Поток пачек бросков кости
+    \details Лениво выдаёт count бросков кости с шансами dice пачками по batch_size. Пачка ссылается на буфер
+   сопрограммы, поэтому значения не копируются.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] dice ссылка на кость, шансы которой используются.
+    \param[in] count кол-во бросков, stream_unlimited - бесконечно.
+    \param[in] batch_size кол-во бросков в пачке.
+
+    \return Генератор пачек.
+
+    \throw std::invalid_argument - если batch_size равен 0. Исключение выбрасывается при первом обращении к генератору.
+*/
+template <size_t Faces>
+RollGenerator<RollBatch> roll_batches(const BasicOneDice<Faces> &dice, const std::uint64_t count,
+                                      const size_t batch_size)
+{
+    if (batch_size == 0)
+        throw std::invalid_argument("Batch size must be positive!");
+    const OddsHandle handle = dice.get_odds_handle();
+    std::vector<NumPoints> buffer(batch_size);
+    for (std::uint64_t left = count; left > 0;)
+    {
+        size_t size = static_cast<size_t>(std::min<std::uint64_t>(left, batch_size));
+        random_odds<Faces>(handle, buffer.data(), size);
+        journal_batch(buffer.data(), size, Faces);
+        co_yield RollBatch{buffer.data(), size};
+        if (left != stream_unlimited)
+            left -= size;
+    }
+}
+
+/*!
+    \brief Поток бросков группы
+    \details Копирует группу dice один раз и лениво выдаёт её после каждого из count бросков всех костей. Выдаётся
+   ссылка на одну и ту же группу, которая меняется при продвижении генератора.
+
+    \param[in] dice ссылка на группу костей.
+    \param[in] count кол-во бросков, stream_unlimited - бесконечно.
+
+    \return Генератор групп.
+*/
+RollGenerator<Dice> roll_stream(const Dice &dice, const std::uint64_t count)
+{
+    Dice group(dice);
+    for (std::uint64_t left = count; left > 0;)
+    {
+        group();
+        co_yield group;
+        if (left != stream_unlimited)
+            --left;
+    }
+}
+
+/*!
+    \brief Общие фоновые потоки
+    \details Возобновляют готовые к работе сопрограммы потоков бросков по очереди. Потоков столько же, сколько ядер.
+   Если не удалось создать ни одного потока, сопрограмма возобновляется сразу в вызывающем потоке.
+*/
+struct StreamExecutor
+{
+        std::mutex mutex;
+        std::condition_variable ready_changed;
+        std::deque<std::coroutine_handle<>> ready;
+        std::vector<std::thread> workers;
+        bool stopping = false;
+
+        StreamExecutor();
+        ~StreamExecutor();
+
+        void post(const std::coroutine_handle<> coroutine);
+        void work();
+};
+
+/*!
+    \brief Конструктор
+    \details Запускает фоновые потоки. Если поток не удалось создать, работают уже созданные.
+*/
+StreamExecutor::StreamExecutor()
+{
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < threads; ++i)
+    {
+        try
+        {
+            workers.emplace_back(&StreamExecutor::work, this);
+        }
+        catch (const std::system_error &)
+        {
+            break;
+        }
+    }
+}
+
+/*!
+    \brief Деструктор
+    \details Дожидается возобновления всех поставленных в очередь сопрограмм и останавливает фоновые потоки.
+*/
+StreamExecutor::~StreamExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready_changed.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+/*!
+    \brief Постановка сопрограммы в очередь
+    \param[in] coroutine сопрограмма, пустая сопрограмма игнорируется.
+*/
+void StreamExecutor::post(const std::coroutine_handle<> coroutine)
+{
+    if (!coroutine)
+        return;
+    if (workers.empty())
+    {
+        coroutine.resume();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(coroutine);
+    }
+    ready_changed.notify_one();
+}
+
+/*!
+    \brief Фоновый поток
+    \details Возобновляет сопрограммы из очереди, пока исполнитель не остановлен.
+*/
+void StreamExecutor::work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        ready_changed.wait(lock, [this]() { return !ready.empty() || stopping; });
+        if (ready.empty())
+            return;
+        std::coroutine_handle<> coroutine = ready.front();
+        ready.pop_front();
+        lock.unlock();
+        coroutine.resume();
+        lock.lock();
+    }
+}
+
+/*!
+    \brief Исполнитель потоков бросков
+    \return Ссылка на общий исполнитель, созданный при первом обращении.
+*/
+static StreamExecutor &get_stream_executor()
+{
+    static StreamExecutor executor;
+    return executor;
+}
+
+/*!
+    \brief Задача генерации
+    \details Сопрограмма без результата, которую возобновляют общие фоновые потоки. Завершается приостановкой в
+   ожидании FinishAwaiter и уничтожается владельцем.
+*/
+struct ProducerTask
+{
+        struct promise_type
+        {
+                ProducerTask get_return_object() noexcept
+                {
+                    return ProducerTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+                std::suspend_always initial_suspend() const noexcept
+                {
+                    return {};
+                }
+                std::suspend_always final_suspend() const noexcept
+                {
+                    return {};
+                }
+                void return_void() const noexcept
+                {
+                }
+                void unhandled_exception() const noexcept
+                {
+                    std::terminate();
+                }
+        };
+
+        std::coroutine_handle<promise_type> handle;
+};
+
+/*!
+    \brief Состояние асинхронного потока
+    \details Очередь готовых пачек, запас пустых буферов и приостановленные сопрограммы генерации и потребителя.
+   Признак active означает, что сопрограмма генерации выполняется или стоит в очереди исполнителя, поэтому её нельзя
+   уничтожать.
+*/
+template <size_t Faces> struct BasicAsyncRollStream<Faces>::State
+{
+        /*!
+            \brief Передача пачки потребителю
+            \details Ожидание co_await ставит пачку в очередь. Если очередь заполнена, сопрограмма
+           приостанавливается и освобождает фоновый поток до запроса потребителя. При остановке потока пачка
+           отбрасывается.
+        */
+        struct PushAwaiter
+        {
+                State &state;
+                Vector<NumPoints> &batch;
+                bool pushed = false;
+
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+                bool await_suspend(const std::coroutine_handle<> producer)
+                {
+                    std::coroutine_handle<> consumer;
+                    bool suspend;
+                    {
+                        std::lock_guard<std::mutex> lock(state.mutex);
+                        suspend = !state.stopping && state.queue.size() >= state.capacity;
+                        if (suspend)
+                        {
+                            state.parked = producer;
+                            state.active = false;
+                            ++state.suspensions;
+                            state.changed.notify_all();
+                        }
+                        else
+                            consumer = push();
+                    }
+                    get_stream_executor().post(consumer);
+                    return suspend;
+                }
+                void await_resume()
+                {
+                    std::coroutine_handle<> consumer;
+                    {
+                        std::lock_guard<std::mutex> lock(state.mutex);
+                        if (!pushed)
+                            consumer = push();
+                    }
+                    get_stream_executor().post(consumer);
+                }
+                std::coroutine_handle<> push()
+                {
+                    pushed = true;
+                    if (state.stopping)
+                        return nullptr;
+                    state.queue.push_back(std::move(batch));
+                    if (!state.spare.empty())
+                    {
+                        batch = std::move(state.spare.back());
+                        state.spare.pop_back();
+                    }
+                    state.changed.notify_all();
+                    return std::exchange(state.waiting, nullptr);
+                }
+        };
+
+        /*!
+            \brief Завершение генерации
+            \details Отмечает поток завершённым и навсегда приостанавливает сопрограмму генерации, после чего её можно
+           уничтожить.
+        */
+        struct FinishAwaiter
+        {
+                State &state;
+                std::exception_ptr error;
+
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+                void await_suspend(const std::coroutine_handle<>)
+                {
+                    std::coroutine_handle<> consumer;
+                    {
+                        std::lock_guard<std::mutex> lock(state.mutex);
+                        state.error = error;
+                        state.finished = true;
+                        state.active = false;
+                        consumer = std::exchange(state.waiting, nullptr);
+                        state.changed.notify_all();
+                    }
+                    get_stream_executor().post(consumer);
+                }
+                void await_resume() const noexcept
+                {
+                }
+        };
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<Vector<NumPoints>> queue;
+        std::vector<Vector<NumPoints>> spare;
+        size_t capacity = 0;
+        bool finished = false;
+        bool stopping = false;
+        bool active = false;
+        std::coroutine_handle<> parked;
+        std::coroutine_handle<> waiting;
+        std::exception_ptr error;
+        std::uint64_t suspensions = 0;
+        ProducerTask task;
+
+        ProducerTask produce(const OddsHandle handle, const std::uint64_t count, const size_t batch_size);
+        bool take(Vector<NumPoints> &batch, std::coroutine_handle<> &producer);
+};
+
+/*!
+    \brief Сопрограмма генерации
+    \details Бросает кость пачками и передаёт их потребителю, пока не брошено count костей или поток не остановлен.
+
+    \param[in] handle номер шансов кости.
+    \param[in] count кол-во бросков.
+    \param[in] batch_size кол-во бросков в пачке.
+
+    \return Задача генерации.
+*/
+template <size_t Faces>
+ProducerTask BasicAsyncRollStream<Faces>::State::produce(const OddsHandle handle, const std::uint64_t count,
+                                                        const size_t batch_size)
+{
+    std::exception_ptr failure;
+    try
+    {
+        Vector<NumPoints> batch;
+        for (std::uint64_t left = count; left > 0;)
+        {
+            size_t size = static_cast<size_t>(std::min<std::uint64_t>(left, batch_size));
+            if (batch.get_size() != size)
+                batch = Vector<NumPoints>(size, 0);
+            random_odds<Faces>(handle, batch.get_data(), size);
+            journal_batch(batch.get_data(), size, Faces);
+            co_await PushAwaiter{*this, batch};
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping)
+                    break;
+            }
+            if (left != stream_unlimited)
+                left -= size;
+        }
+    }
+    catch (...)
+    {
+        failure = std::current_exception();
+    }
+    co_await FinishAwaiter{*this, failure};
+}
+
+/*!
+    \brief Получение готовой пачки
+    \details Обменивает первую пачку очереди с batch и возвращает прежний буфер batch в запас. Если генерация была
+   приостановлена, возвращает её сопрограмму в producer для возобновления. Вызывается под мьютексом.
+
+    \param[in,out] batch ссылка на буфер пачки.
+    \param[out] producer ссылка на сопрограмму генерации, которую нужно возобновить.
+
+    \return True если пачка получена. False если очередь пуста и все броски уже выданы.
+
+    \throw - исключение, выброшенное при генерации.
+*/
+template <size_t Faces>
+bool BasicAsyncRollStream<Faces>::State::take(Vector<NumPoints> &batch, std::coroutine_handle<> &producer)
+{
+    if (queue.empty())
+    {
+        if (error)
+            std::rethrow_exception(error);
+        return false;
+    }
+    std::swap(batch, queue.front());
+    if (spare.size() <= capacity)
+        spare.push_back(std::move(queue.front()));
+    queue.pop_front();
+    if (parked && !stopping)
+    {
+        producer = std::exchange(parked, nullptr);
+        active = true;
+    }
+    return true;
+}
+
+/*!
+    \brief Конструктор ожидания
+    \param[in] stream_state ссылка на состояние потока.
+    \param[in,out] output ссылка на буфер пачки.
+*/
+template <size_t Faces>
+BasicAsyncRollStream<Faces>::NextAwaiter::NextAwaiter(State &stream_state, Vector<NumPoints> &output) noexcept
+    : state(stream_state), batch(output)
+{
+}
+
+/*!
+    \brief Проверка готовности
+    \return True если пачка готова или все броски уже выданы.
+*/
+template <size_t Faces> bool BasicAsyncRollStream<Faces>::NextAwaiter::await_ready() const
+{
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return !state.queue.empty() || state.finished;
+}
+
+/*!
+    \brief Приостановка потребителя
+    \details Запоминает сопрограмму потребителя, если пачка так и не готова.
+
+    \param[in] consumer сопрограмма потребителя.
+
+    \return True если сопрограмма приостановлена. False если пачка успела появиться.
+*/
+template <size_t Faces>
+bool BasicAsyncRollStream<Faces>::NextAwaiter::await_suspend(const std::coroutine_handle<> consumer) const
+{
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.queue.empty() || state.finished)
+        return false;
+    state.waiting = consumer;
+    return true;
+}
+
+/*!
+    \brief Результат ожидания
+    \return True если пачка получена. False если все броски уже выданы.
+
+    \throw - исключение, выброшенное при генерации.
+*/
+template <size_t Faces> bool BasicAsyncRollStream<Faces>::NextAwaiter::await_resume() const
+{
+    std::coroutine_handle<> producer;
+    bool taken;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        taken = state.take(batch, producer);
+    }
+    get_stream_executor().post(producer);
+    return taken;
+}
+
+/*!
+    \brief Конструктор
+    \details Создаёт сопрограмму генерации бросков кости с шансами dice и ставит её в очередь общих фоновых потоков.
+
+    \param[in] dice ссылка на кость, шансы которой используются.
+    \param[in] count кол-во бросков, stream_unlimited - бесконечно.
+    \param[in] batch_size кол-во бросков в пачке.
+    \param[in] capacity кол-во готовых пачек, после которого генерация приостанавливается.
+
+    \throw std::invalid_argument - если batch_size или capacity равны 0.
+*/
+template <size_t Faces>
+BasicAsyncRollStream<Faces>::BasicAsyncRollStream(const BasicOneDice<Faces> &dice, const std::uint64_t count,
+                                                  const size_t batch_size, const size_t capacity)
+    : state(new State)
+{
+    if (batch_size == 0 || capacity == 0)
+        throw std::invalid_argument("Batch size and capacity must be positive!");
+    state->capacity = capacity;
+    state->task = state->produce(dice.get_odds_handle(), count, batch_size);
+    state->active = true;
+    get_stream_executor().post(state->task.handle);
+}
+
+/*!
+    \brief Деструктор
+    \details Останавливает генерацию, дожидается, пока сопрограмма генерации приостановится или завершится, и
+   уничтожает её.
+*/
+template <size_t Faces> BasicAsyncRollStream<Faces>::~BasicAsyncRollStream()
+{
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->stopping = true;
+    state->changed.wait(lock, [this]() { return !state->active; });
+    lock.unlock();
+    state->task.handle.destroy();
+}
+
+/*!
+    \brief Получение пачки
+    \details Блокирует поток до готовности пачки и обменивает её с batch, поэтому значения не копируются, а прежний
+   буфер batch возвращается в запас для следующих пачек. Если генерация была приостановлена, возобновляет её.
+
+    \param[in,out] batch ссылка на буфер пачки.
+
+    \return True если пачка получена. False если все броски уже выданы.
+
+    \throw - исключение, выброшенное при генерации.
+*/
+template <size_t Faces> bool BasicAsyncRollStream<Faces>::next(Vector<NumPoints> &batch)
+{
+    std::coroutine_handle<> producer;
+    bool taken;
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->changed.wait(lock, [this]() { return !state->queue.empty() || state->finished; });
+        taken = state->take(batch, producer);
+    }
+    get_stream_executor().post(producer);
+    return taken;
+}
+
+/*!
+    \brief Ожидание пачки в сопрограмме
+    \details То же, что next(), но для co_await: сопрограмма потребителя приостанавливается вместо блокировки потока.
+
+    \param[in,out] batch ссылка на буфер пачки.
+
+    \return Объект ожидания, результат co_await которого совпадает с результатом next().
+*/
+template <size_t Faces>
+typename BasicAsyncRollStream<Faces>::NextAwaiter BasicAsyncRollStream<Faces>::next_async(Vector<NumPoints> &batch)
+{
+    return NextAwaiter(*state, batch);
+}
+
+/*!
+    \brief Геттер кол-ва приостановок
+    \return Сколько раз генерация приостанавливалась из-за заполненной очереди.
+*/
+template <size_t Faces> std::uint64_t BasicAsyncRollStream<Faces>::get_suspensions() const
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->suspensions;
+}
+
+template RollGenerator<NumPoints> roll_stream(const BasicOneDice<4> &dice, const std::uint64_t count);
+template RollGenerator<RollBatch> roll_batches(const BasicOneDice<4> &dice, const std::uint64_t count,
+                                               const size_t batch_size);
+template class BasicAsyncRollStream<4>;
+
+template RollGenerator<NumPoints> roll_stream(const BasicOneDice<6> &dice, const std::uint64_t count);
+template RollGenerator<RollBatch> roll_batches(const BasicOneDice<6> &dice, const std::uint64_t count,
+                                               const size_t batch_size);
+template class BasicAsyncRollStream<6>;
+
+template RollGenerator<NumPoints> roll_stream(const BasicOneDice<8> &dice, const std::uint64_t count);
+template RollGenerator<RollBatch> roll_batches(const BasicOneDice<8> &dice, const std::uint64_t count,
+                                               const size_t batch_size);
+template class BasicAsyncRollStream<8>;
+
+template RollGenerator<NumPoints> roll_stream(const BasicOneDice<10> &dice, const std::uint64_t count);
+template RollGenerator<RollBatch> roll_batches(const BasicOneDice<10> &dice, const std::uint64_t count,
+                                               const size_t batch_size);
+template class BasicAsyncRollStream<10>;
+
+template RollGenerator<NumPoints> roll_stream(const BasicOneDice<12> &dice, const std::uint64_t count);
+template RollGenerator<RollBatch> roll_batches(const BasicOneDice<12> &dice, const std::uint64_t count,
+                                               const size_t batch_size);
+template class BasicAsyncRollStream<12>;
+
+template RollGenerator<NumPoints> roll_stream(const BasicOneDice<20> &dice, const std::uint64_t count);
+template RollGenerator<RollBatch> roll_batches(const BasicOneDice<20> &dice, const std::uint64_t count,
+                                               const size_t batch_size);
+template class BasicAsyncRollStream<20>;
+
+template RollGenerator<NumPoints> roll_stream(const BasicOneDice<100> &dice, const std::uint64_t count);
+template RollGenerator<RollBatch> roll_batches(const BasicOneDice<100> &dice, const std::uint64_t count,
+                                               const size_t batch_size);
+template class BasicAsyncRollStream<100>;
+
+/*! @} */
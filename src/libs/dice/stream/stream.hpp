@@ -0,0 +1,247 @@
+/*!
+    \defgroup Stream_submodule Ленивые потоки бросков
+    \ingroup Dice_module
+    \brief Генераторы бросков на сопрограммах C++20
+*/
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+/*!
+    \addtogroup Stream_submodule
+    @{
+*/
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "../dice.hpp"
+
+constexpr std::uint64_t stream_unlimited = std::numeric_limits<std::uint64_t>::max(); ///< Бесконечный поток
+constexpr size_t stream_batch = 4096;  ///< Кол-во бросков в пачке по умолчанию
+constexpr size_t stream_capacity = 4;  ///< Кол-во готовых пачек, после которого фоновый поток приостанавливается
+
+/*!
+    \brief Шаблон генератора
+    \details Объект RollGenerator владеет сопрограммой, которая выдаёт значения через co_yield. Значения вычисляются
+   только при продвижении итератора, а итератор ссылается на значение в кадре сопрограммы без копирования. Генератор
+   можно обойти один раз.
+
+    \tparam T тип выдаваемого значения.
+*/
+template <typename T> class RollGenerator
+{
+    public:
+        /*!
+            \brief Состояние сопрограммы
+            \details Хранит указатель на последнее выданное значение и исключение, выброшенное в сопрограмме.
+        */
+        struct promise_type
+        {
+                const T *current = nullptr;
+                std::exception_ptr error;
+
+                RollGenerator get_return_object() noexcept
+                {
+                    return RollGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+                std::suspend_always initial_suspend() const noexcept
+                {
+                    return {};
+                }
+                std::suspend_always final_suspend() const noexcept
+                {
+                    return {};
+                }
+                std::suspend_always yield_value(const T &value) noexcept
+                {
+                    current = std::addressof(value);
+                    return {};
+                }
+                void return_void() const noexcept
+                {
+                }
+                void unhandled_exception() noexcept
+                {
+                    error = std::current_exception();
+                }
+        };
+
+        /*!
+            \brief Итератор генератора
+            \details Продвижение итератора возобновляет сопрограмму до следующего co_yield.
+        */
+        class iterator
+        {
+            private:
+                std::coroutine_handle<promise_type> handle;
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using difference_type = std::ptrdiff_t;
+                using value_type = T;
+
+                iterator() noexcept = default;
+                explicit iterator(const std::coroutine_handle<promise_type> coroutine) noexcept : handle(coroutine)
+                {
+                }
+
+                const T &operator*() const noexcept
+                {
+                    return *handle.promise().current;
+                }
+                const T *operator->() const noexcept
+                {
+                    return handle.promise().current;
+                }
+                iterator &operator++()
+                {
+                    resume(handle);
+                    return *this;
+                }
+                void operator++(int)
+                {
+                    ++*this;
+                }
+                bool operator==(std::default_sentinel_t) const noexcept
+                {
+                    return !handle || handle.done();
+                }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+        explicit RollGenerator(const std::coroutine_handle<promise_type> coroutine) noexcept : handle(coroutine)
+        {
+        }
+
+        /*!
+            \brief Возобновление сопрограммы
+            \details Возобновляет сопрограмму и пробрасывает выброшенное в ней исключение.
+
+            \param[in] coroutine сопрограмма генератора.
+        */
+        static void resume(const std::coroutine_handle<promise_type> coroutine)
+        {
+            coroutine.resume();
+            if (coroutine.promise().error)
+                std::rethrow_exception(std::exchange(coroutine.promise().error, nullptr));
+        }
+
+    public:
+        RollGenerator(const RollGenerator &other) = delete;
+        RollGenerator &operator=(const RollGenerator &other) = delete;
+
+        RollGenerator(RollGenerator &&other) noexcept : handle(std::exchange(other.handle, nullptr))
+        {
+        }
+        RollGenerator &operator=(RollGenerator &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+        ~RollGenerator()
+        {
+            if (handle)
+                handle.destroy();
+        }
+
+        iterator begin()
+        {
+            if (handle)
+                resume(handle);
+            return iterator(handle);
+        }
+        std::default_sentinel_t end() const noexcept
+        {
+            return std::default_sentinel;
+        }
+};
+
+/*!
+    \brief Пачка бросков
+    \details Ссылается на значения в буфере генератора. Значения действительны до следующего продвижения генератора.
+*/
+struct RollBatch
+{
+        const NumPoints *values = nullptr; ///< Указатель на первое значение
+        size_t size = 0;                   ///< Кол-во значений
+
+        const NumPoints *begin() const noexcept
+        {
+            return values;
+        }
+        const NumPoints *end() const noexcept
+        {
+            return values + size;
+        }
+};
+
+template <size_t Faces>
+RollGenerator<NumPoints> roll_stream(const BasicOneDice<Faces> &dice, const std::uint64_t count = stream_unlimited);
+template <size_t Faces>
+RollGenerator<RollBatch> roll_batches(const BasicOneDice<Faces> &dice, const std::uint64_t count = stream_unlimited,
+                                      const size_t batch_size = stream_batch);
+RollGenerator<Dice> roll_stream(const Dice &dice, const std::uint64_t count = stream_unlimited);
+
+/*!
+    \brief Шаблон асинхронного потока бросков
+    \details Объект BasicAsyncRollStream бросает кость пачками по batch_size бросков. Генерацию ведёт сопрограмма,
+   которую возобновляют общие для всех потоков бросков фоновые потоки. Когда готово capacity пачек, сопрограмма
+   приостанавливается и не занимает фоновый поток, пока потребитель не заберёт пачку. Потребитель может ждать пачку,
+   блокируя поток, через next() или приостанавливая свою сопрограмму через co_await next_async(). Буферы пачек
+   переиспользуются.
+
+    \tparam Faces кол-во граней кости.
+*/
+template <size_t Faces> class BasicAsyncRollStream
+{
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+
+    public:
+        /*!
+            \brief Ожидание пачки в сопрограмме
+            \details Результат co_await совпадает с результатом next(). Если пачка ещё не готова, сопрограмма
+           потребителя приостанавливается и возобновляется фоновым потоком, положившим пачку.
+        */
+        class NextAwaiter
+        {
+            private:
+                State &state;
+                Vector<NumPoints> &batch;
+
+            public:
+                NextAwaiter(State &stream_state, Vector<NumPoints> &output) noexcept;
+
+                bool await_ready() const;
+                bool await_suspend(const std::coroutine_handle<> consumer) const;
+                bool await_resume() const;
+        };
+
+        BasicAsyncRollStream(const BasicOneDice<Faces> &dice, const std::uint64_t count = stream_unlimited,
+                             const size_t batch_size = stream_batch, const size_t capacity = stream_capacity);
+        BasicAsyncRollStream(const BasicAsyncRollStream &other) = delete;
+        BasicAsyncRollStream &operator=(const BasicAsyncRollStream &other) = delete;
+        ~BasicAsyncRollStream();
+
+        bool next(Vector<NumPoints> &batch);
+        NextAwaiter next_async(Vector<NumPoints> &batch);
+        std::uint64_t get_suspensions() const;
+};
+
+typedef BasicAsyncRollStream<6> AsyncRollStream; ///< Асинхронный поток бросков шестигранной кости
+
+/*! @} */
+
+#endif // STREAM_HPP
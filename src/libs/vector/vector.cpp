@@ -87,7 +87,7 @@ template <typename T> Vector<T>::~Vector() noexcept
 template <typename T> void Vector<T>::push_back(const T &value)
 {
     if (size == capacity)
-        resize(capacity * 2);
+        resize(std::max<size_t>(capacity * 2, 1));
     data[size++] = value;
 }
 
@@ -98,7 +98,7 @@ template <typename T> void Vector<T>::push_back(const T &value)
 template <typename T> void Vector<T>::push_front(const T &value)
 {
     if (size == capacity)
-        resize(capacity * 2);
+        resize(std::max<size_t>(capacity * 2, 1));
     std::copy_backward(data, data + size, data + size + 1);
     data[0] = value;
 }
@@ -139,7 +139,7 @@ template <typename T> typename Vector<T>::iterator Vector<T>::insert(iterator po
         throw std::invalid_argument("Invalid position");
     size_t pos_index = position - begin();
     if (size == capacity)
-        resize(capacity * 2);
+        resize(std::max<size_t>(capacity * 2, 1));
     std::copy_backward(data + pos_index, data + size, data + size + 1);
     Vector<T>::iterator new_pos = iterator(data + pos_index);
     *new_pos = value;
@@ -167,7 +167,7 @@ template <typename T> typename Vector<T>::iterator Vector<T>::insert(iterator po
     size_t dist = last - first;
     size_t pos_index = position - begin();
     while (capacity - size < dist)
-        resize(capacity * 2);
+        resize(std::max<size_t>(capacity * 2, 1));
     std::copy_backward(data + pos_index, data + size, data + size + dist);
     std::copy(first, last, data + pos_index);
     size += dist;
@@ -256,6 +256,28 @@ template <typename T> size_t Vector<T>::get_size() const noexcept
     return size;
 }
 
+/*!
+    \brief Геттер массива
+    \details Возвращает указатель на начало массива элементов для пакетной обработки.
+
+    \return Указатель на первый элемент вектора.
+*/
+template <typename T> T *Vector<T>::get_data() noexcept
+{
+    return data;
+}
+
+/*!
+    \brief Геттер массива
+    \details Возвращает указатель на начало неизменяемого массива элементов для пакетной обработки.
+
+    \return Указатель на первый элемент вектора.
+*/
+template <typename T> const T *Vector<T>::get_data() const noexcept
+{
+    return data;
+}
+
 /*!
     \brief Оператор []
     \details Перегрузка оператора [] для доступа к элементу вектора по индексу.
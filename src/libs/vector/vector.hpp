@@ -51,6 +51,9 @@ template <typename T> class Vector
 
         size_t get_size() const noexcept;
 
+        T *get_data() noexcept;
+        const T *get_data() const noexcept;
+
         T &operator[](const size_t index);
         T operator[](const size_t index) const;
         Vector &operator=(const Vector<T> &other);
@@ -2,7 +2,7 @@
 
 int main()
 {
-    srand(time(NULL));
+    seed_random(time(NULL));
     try
     {
         program_init();
@@ -1,8 +1,24 @@
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <future>
 #include <gtest/gtest.h>
 #include <numeric>
 #include <sstream>
+#include <thread>
 
 #include "../src/libs/dice/dice.hpp"
+#include "../src/libs/dice/random/prefetch/prefetch.hpp"
+#include "../src/libs/dice/distribution/distribution.hpp"
+#include "../src/libs/dice/journal/journal.hpp"
+#include "../src/libs/dice/parser/parser.hpp"
+#include "../src/libs/dice/scoring/scoring.hpp"
+#include "../src/libs/dice/simulation/simulation.hpp"
+#include "../src/libs/dice/solver/solver.hpp"
+#include "../src/libs/dice/concurrent/concurrent.hpp"
+#include "../src/libs/dice/storage/storage.hpp"
+#include "../src/libs/dice/stream/stream.hpp"
 
 TEST(DiceTest, DefaultConstructor)
 {
@@ -41,7 +57,7 @@ TEST(DiceTest, GetAsciiArt)
     Dice dice = Dice(Vector<NumPoints>({1, 2, 3, 4, 5}));
     OneDice dices[5] = {OneDice(1), OneDice(2), OneDice(3), OneDice(4), OneDice(5)};
     AsciiArt art = std::accumulate(dices + 1, dices + 5, dices[0].get_value_AsciiArt(),
-                                   [](AsciiArt &a, const OneDice &b) { return a + b.get_value_AsciiArt(); });
+                                   [](AsciiArt a, const OneDice &b) { return a + b.get_value_AsciiArt(); });
     std::ostringstream ss;
     std::ostringstream answer;
     ss << dice.get_AsciiArt();
@@ -124,6 +140,16 @@ TEST(DiceTest, OperatorInput)
     ASSERT_TRUE(dice.has_NumPoints(1));
     ASSERT_TRUE(dice.has_NumPoints(2));
     ASSERT_TRUE(dice.has_NumPoints(3));
+
+    Dice larger(5);
+    std::istringstream two("2 6 6");
+    two >> larger;
+    ASSERT_EQ(larger.get_size(), 2);
+    ASSERT_EQ(larger.sum(), 12);
+
+    std::istringstream huge("18446744073709551615 1 2");
+    ASSERT_THROW(huge >> dice, std::invalid_argument);
+    ASSERT_EQ(dice.get_size(), 0);
 }
 
 TEST(DiceTest, OperatorOutput)
@@ -194,4 +220,1036 @@ TEST(OddsTest, CopyConstructor)
     {
         ASSERT_EQ(data[i], i + 1);
     }
-}
\ No newline at end of file
+}
+TEST(OneDiceTest, FacesRange)
+{
+    BasicOneDice<4> d4;
+    BasicOneDice<20> d20;
+    BasicOneDice<100> d100;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(check_NumPoints<4>(d4.to_change_value()));
+        ASSERT_TRUE(check_NumPoints<20>(d20.to_change_value()));
+        ASSERT_TRUE(check_NumPoints<100>(d100.to_change_value()));
+    }
+    ASSERT_THROW(d4.set_value(5), std::invalid_argument);
+    ASSERT_NO_THROW(d20.set_value(20));
+}
+
+TEST(OneDiceTest, WeightedFaces)
+{
+    Chance ch4[4] = {0, 0, 1, 0};
+    Chance ch20[20] = {};
+    ch20[16] = 1;
+    BasicOneDice<4> d4((BasicOdds<4>(ch4)));
+    BasicOneDice<20> d20((BasicOdds<20>(ch20)));
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(d4.to_change_value(), 3);
+        ASSERT_EQ(d20.to_change_value(), 17);
+    }
+}
+
+TEST(OneDiceTest, GuidedFaces)
+{
+    Chance ch100[100] = {};
+    ch100[0] = 1;
+    ch100[49] = 2;
+    ch100[99] = 1;
+    BasicOneDice<100> d100((BasicOdds<100>(ch100)));
+    size_t counts[101] = {};
+    for (size_t i = 0; i < 40000; ++i)
+        ++counts[d100.to_change_value()];
+    ASSERT_EQ(counts[1] + counts[50] + counts[100], 40000);
+    ASSERT_NEAR(counts[50] / 40000.0, 0.5, 0.02);
+
+    const OddsTable<100> &table = OddsRegistry<100>::get_table(d100.get_odds_handle());
+    ASSERT_EQ(table.guide[0], 1);
+    ASSERT_EQ(table.guide[(size_t(1) << odds_guide_bits) - 1], 100);
+}
+
+TEST(OneDiceTest, RuntimeFaces)
+{
+    RuntimeOneDice d7(7);
+    ASSERT_EQ(d7.get_faces(), 7);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        NumPoints value = d7.to_change_value();
+        ASSERT_TRUE(value >= 1 && value <= 7);
+    }
+    Chance ch[30] = {};
+    ch[28] = 3;
+    ch[2] = 1;
+    RuntimeOneDice d30(ch, 30);
+    size_t high = 0;
+    for (size_t i = 0; i < 4000; ++i)
+    {
+        NumPoints value = d30.to_change_value();
+        ASSERT_TRUE(value == 3 || value == 29);
+        high += value == 29;
+    }
+    ASSERT_NEAR(high / 4000.0, 0.75, 0.03);
+    ASSERT_EQ(d30.get_odds(28), 3);
+    ASSERT_EQ(RuntimeOneDice(5, 9), RuntimeOneDice(5, 9));
+    ASSERT_THROW(RuntimeOneDice(10, 9), std::invalid_argument);
+    ASSERT_THROW(RuntimeOneDice(1), std::invalid_argument);
+    ASSERT_THROW(d30.get_odds(30), std::out_of_range);
+    std::ostringstream ss;
+    ss << RuntimeOneDice(7, 9).get_value_AsciiArt();
+    ASSERT_NE(ss.str().find("|   7   | / "), std::string::npos);
+}
+
+TEST(OneDiceTest, NumberAsciiArt)
+{
+    std::ostringstream ss;
+    ss << BasicOneDice<20>(17).get_value_AsciiArt();
+    ASSERT_NE(ss.str().find("|  17   | / "), std::string::npos);
+}
+
+TEST(OddsRegistryTest, Intern)
+{
+    Chance ch[6] = {1, 2, 3, 4, 5, 6};
+    OddsHandle handle = OddsRegistry<6>::intern(Odds(ch));
+    ASSERT_EQ(OddsRegistry<6>::intern(Odds(ch)), handle);
+    ASSERT_EQ(OddsRegistry<6>::intern(Odds()), fair_odds_handle);
+    ASSERT_TRUE(OddsRegistry<6>::get_table(fair_odds_handle).fair);
+    ASSERT_FALSE(OddsRegistry<6>::get_table(handle).fair);
+    ASSERT_EQ(OddsRegistry<6>::get_table(handle).last_face, 6);
+    ASSERT_EQ(OneDice(3, Odds(ch)).get_odds_handle(), handle);
+    ASSERT_THROW(OddsRegistry<6>::get_odds(OddsRegistry<6>::get_size()), std::out_of_range);
+    Chance zero[6] = {};
+    ASSERT_THROW(OddsRegistry<6>::intern(Odds(zero)), std::invalid_argument);
+}
+
+TEST(OneDiceTest, Size)
+{
+    ASSERT_EQ(sizeof(OneDice), sizeof(OddsHandle) + sizeof(NumPoints));
+}
+
+TEST(OddsTest, Probabilities)
+{
+    double probabilities[6] = {0.5, 0.25, 0.125, 0.125, 0, 0};
+    Odds data(probabilities);
+    ASSERT_EQ(data[0], probability_scale / 2);
+    ASSERT_EQ(data[1], probability_scale / 4);
+    ASSERT_EQ(data[4], 0);
+    const OddsTable<6> &table = OddsRegistry<6>::get_table(OddsRegistry<6>::intern(data));
+    ASSERT_EQ(table.thresholds[0], 0x80000000u);
+    ASSERT_EQ(table.thresholds[1], 0xC0000000u);
+    ASSERT_EQ(table.last_face, 4);
+
+    double thirds[6] = {1.0 / 3, 1.0 / 3, 1.0 / 3, 0, 0, 0};
+    Odds rounded(thirds);
+    Chance total = 0;
+    for (size_t i = 0; i < 6; ++i)
+        total += rounded[i];
+    ASSERT_EQ(total, probability_scale);
+
+    double negative[6] = {-0.5, 0.5, 0.5, 0.5, 0, 0};
+    double wrong_sum[6] = {0.5, 0.5, 0.5, 0, 0, 0};
+    ASSERT_THROW(Odds{negative}, std::invalid_argument);
+    ASSERT_THROW(Odds{wrong_sum}, std::invalid_argument);
+}
+
+TEST(RandomTest, Seed)
+{
+    OneDice dice;
+    seed_random(42);
+    NumPoints first[16];
+    for (size_t i = 0; i < 16; ++i)
+        first[i] = dice.to_change_value();
+    seed_random(42);
+    for (size_t i = 0; i < 16; ++i)
+        ASSERT_EQ(dice.to_change_value(), first[i]);
+}
+
+TEST(SamplingTest, SimdLevels)
+{
+    Chance ch[6] = {1, 2, 3, 4, 5, 6};
+    OddsHandle handle = OddsRegistry<6>::intern(Odds(ch));
+    SimdLevel levels[3] = {SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2};
+    NumPoints faces[3][1003];
+    NumPoints fair[3][1003];
+    for (size_t level = 0; level < 3; ++level)
+    {
+        set_SimdLevel(levels[level]);
+        seed_random(7);
+        random_odds<6>(handle, faces[level], 1003);
+        random_odds<6>(fair_odds_handle, fair[level], 1003);
+    }
+    for (size_t i = 0; i < 1003; ++i)
+    {
+        ASSERT_TRUE(check_NumPoints(faces[0][i]));
+        ASSERT_TRUE(check_NumPoints(fair[0][i]));
+        ASSERT_EQ(faces[0][i], faces[1][i]);
+        ASSERT_EQ(faces[0][i], faces[2][i]);
+        ASSERT_EQ(fair[0][i], fair[1][i]);
+        ASSERT_EQ(fair[0][i], fair[2][i]);
+    }
+}
+
+TEST(SamplingTest, Weighted)
+{
+    Chance ch[20] = {};
+    ch[0] = 1;
+    ch[18] = 1;
+    NumPoints faces[1000];
+    random_odds<20>(OddsRegistry<20>::intern(BasicOdds<20>(ch)), faces, 1000);
+    for (NumPoints face : faces)
+        ASSERT_TRUE(face == 1 || face == 19);
+}
+
+TEST(DiceTest, OperatorScopeMixedOdds)
+{
+    Chance ch[6] = {0, 0, 0, 0, 0, 1};
+    Dice dice(1000);
+    dice += OneDice(1, Odds(ch));
+    dice += OneDice(1, Odds(ch));
+    dice();
+    ASSERT_EQ(dice[1000].get_value(), 6);
+    ASSERT_EQ(dice[1001].get_value(), 6);
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_TRUE(check_NumPoints(dice[i].get_value()));
+}
+
+TEST(RandomTest, Prefetch)
+{
+    RandomRing ring(8);
+    RandomWord words[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    ASSERT_EQ(ring.push(words, 10), 8);
+    RandomWord word;
+    for (RandomWord i = 1; i <= 8; ++i)
+    {
+        ASSERT_TRUE(ring.pop(word));
+        ASSERT_EQ(word, i);
+    }
+    ASSERT_FALSE(ring.pop(word));
+    ASSERT_THROW(RandomRing(6), std::invalid_argument);
+
+    start_random_prefetch(1024);
+    OneDice dice;
+    for (size_t i = 0; i < 100000; ++i)
+        ASSERT_TRUE(check_NumPoints(dice.to_change_value()));
+    RandomPrefetchStats stats = get_random_prefetch_stats();
+    ASSERT_EQ(stats.consumed + stats.underruns, 100001);
+    stop_random_prefetch();
+    ASSERT_EQ(get_random_prefetch_stats().consumed, 0);
+}
+
+TEST(RandomTest, Entropy)
+{
+    set_random_source(RandomSource::entropy);
+    ASSERT_EQ(get_random_source(), RandomSource::entropy);
+    for (size_t i = 0; i < 1000; ++i)
+        ASSERT_LT(random_below(3), 3);
+    ASSERT_THROW(random_below(0), std::invalid_argument);
+
+    Chance ch[6] = {0, 1, 0, 2, 0, 0};
+    OneDice dice(2, Odds(ch));
+    NumPoints faces[entropy_buffer_words + 10];
+    random_odds<6>(dice.get_odds_handle(), faces, entropy_buffer_words + 10);
+    for (NumPoints face : faces)
+        ASSERT_TRUE(face == 2 || face == 4);
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        NumPoints value = dice.to_change_value();
+        ASSERT_TRUE(value == 2 || value == 4);
+    }
+    set_random_source(RandomSource::xorshift);
+    ASSERT_EQ(get_random_source(), RandomSource::xorshift);
+}
+
+TEST(RandomTest, Philox)
+{
+    std::uint32_t counter[4] = {0, 0, 0, 0}, key[2] = {0, 0};
+    RandomWord words[philox_words];
+    philox4x32(counter, key, words);
+    ASSERT_EQ(words[0], 0x6627e8d5u);
+    ASSERT_EQ(words[3], 0x9b00dbd8u);
+
+    CounterEngine engine(42, 7);
+    RandomWord filled[10];
+    engine.fill(3, 5, filled, 10);
+    for (size_t i = 0; i < 10; ++i)
+        ASSERT_EQ(filled[i], engine.get_word(3 + i, 5));
+    ASSERT_NE(engine.get_word(3, 5), CounterEngine(42, 8).get_word(3, 5));
+}
+
+TEST(DiceTest, CounterEngine)
+{
+    Chance ch[6] = {1, 0, 0, 2, 0, 3};
+    Dice dice(300);
+    dice[150].set_odds(Odds(ch));
+    ASSERT_THROW(dice.get_roll(0, 1), std::logic_error);
+    dice.set_CounterEngine(CounterEngine(1234, 1));
+    dice();
+    Dice first = dice;
+    dice();
+    dice(10);
+    ASSERT_EQ(dice.get_epoch(), 3);
+    for (size_t i = 0; i < 300; ++i)
+        ASSERT_EQ(first[i].get_value(), dice.get_roll(i, 1));
+    ASSERT_EQ(dice[10].get_value(), dice.get_roll(10, 3));
+    NumPoints weighted = dice.get_roll(150, 2);
+    ASSERT_TRUE(weighted == 1 || weighted == 4 || weighted == 6);
+    ASSERT_EQ(dice.replay(0, 1), first[0].get_value());
+    ASSERT_EQ(dice.get_epoch(), 3);
+    ASSERT_THROW(dice.get_roll(11, 3), std::invalid_argument);
+    ASSERT_THROW(dice.replay(11, 3), std::invalid_argument);
+    ASSERT_THROW(dice.get_roll(10, 4), std::invalid_argument);
+    ASSERT_THROW(dice.get_roll(10, 0), std::invalid_argument);
+    Dice copy = dice;
+    ASSERT_THROW(copy.get_roll(11, 3), std::invalid_argument);
+    dice.set_CounterEngine(CounterEngine(1234, 1), 3);
+    ASSERT_NO_THROW(dice.get_roll(11, 3));
+
+    Dice other(300);
+    other[150].set_odds(Odds(ch));
+    other.set_CounterEngine(CounterEngine(1234, 1));
+    other();
+    for (size_t i = 0; i < 300; ++i)
+        ASSERT_EQ(first[i], other[i]);
+    dice.reset_CounterEngine();
+    ASSERT_FALSE(dice.is_counter_based());
+}
+
+TEST(DiceTest, PackedStorage)
+{
+    Chance ch[6] = {0, 0, 1, 0, 0, 0};
+    Dice dice = Dice(Vector<NumPoints>({1, 2, 3, 2, 5}));
+    dice[1].set_odds(Odds(ch));
+    dice[4] = OneDice(6, Odds(ch));
+    ASSERT_EQ(dice.get_values()[4], 6);
+    ASSERT_EQ(dice.get_odds_handles()[4], dice[1].get_odds_handle());
+    ASSERT_EQ(dice[1].to_change_value(), 3);
+    dice -= 3;
+    ASSERT_EQ(dice.get_size(), 3);
+    const Dice &packed = dice;
+    ASSERT_EQ(packed[0], OneDice(1));
+    ASSERT_EQ(packed[1], OneDice(2));
+    ASSERT_EQ(packed[2], OneDice(6, Odds(ch)));
+    ASSERT_THROW(dice[0].set_value(7), std::invalid_argument);
+    ASSERT_THROW(Dice(Vector<NumPoints>({1, 0})), std::invalid_argument);
+}
+
+TEST(DiceTest, ValuesConstructor)
+{
+    PackedNumPoints packed[5] = {1, 6, 3, 3, 2};
+    NumPoints wide[3] = {4, 5, 6};
+    seed_random(99);
+    RandomWord expected = random_word();
+    seed_random(99);
+    Dice dice(packed, packed + 5);
+    Dice other(wide, wide + 3);
+    ASSERT_EQ(random_word(), expected);
+    ASSERT_EQ(dice.sum(), 15);
+    ASSERT_EQ(other.sum(), 15);
+    ASSERT_EQ(dice.get_values()[1], 6);
+    PackedNumPoints invalid[2] = {1, 7};
+    ASSERT_THROW(Dice(invalid, invalid + 2), std::invalid_argument);
+    ASSERT_THROW(Dice(invalid + 2, invalid), std::invalid_argument);
+}
+
+TEST(DiceTest, FaceCounts)
+{
+    Dice dice = Dice(Vector<NumPoints>({1, 2, 2, 6}));
+    ASSERT_EQ(dice.count_NumPoints(2), 2);
+    dice[1].set_value(5);
+    dice[0] = OneDice(6);
+    dice += OneDice(3);
+    ASSERT_EQ(dice.sum(), 22);
+    ASSERT_EQ(dice.count_NumPoints(6), 2);
+    ASSERT_FALSE(dice.has_NumPoints(1));
+    dice -= 6;
+    ASSERT_EQ(dice.sum(), 10);
+    ASSERT_EQ(dice.count_NumPoints(6), 0);
+    for (size_t roll = 0; roll < 10; ++roll)
+    {
+        roll % 2 ? dice() : (void)dice(roll % dice.get_size());
+        NumPoints expected = 0;
+        size_t total = 0;
+        for (size_t i = 0; i < dice.get_size(); ++i)
+            expected += dice[i].get_value();
+        for (NumPoints face = 1; face <= 6; ++face)
+            total += dice.count_NumPoints(face);
+        ASSERT_EQ(dice.sum(), expected);
+        ASSERT_EQ(total, dice.get_size());
+    }
+    ASSERT_THROW(dice.count_NumPoints(0), std::invalid_argument);
+}
+
+TEST(DiceTest, RemoveMask)
+{
+    Chance ch[6] = {1, 1, 1, 1, 1, 0};
+    Dice dice = Dice(Vector<NumPoints>({1, 6, 2, 6, 3, 1, 4}));
+    dice[4].set_odds(Odds(ch));
+    ASSERT_EQ(dice.remove_NumPoints(to_FaceMask(1) | to_FaceMask(6)), 4);
+    ASSERT_EQ(dice.get_size(), 3);
+    ASSERT_EQ(dice.sum(), 9);
+    ASSERT_EQ(dice[0].get_value(), 2);
+    ASSERT_EQ(dice[1], OneDice(3, Odds(ch)));
+    ASSERT_EQ(dice[2].get_value(), 4);
+    ASSERT_EQ(dice.remove_NumPoints(to_FaceMask(5)), 0);
+    ASSERT_THROW(dice.remove_NumPoints(to_FaceMask(7)), std::invalid_argument);
+
+    size_t removed = dice.remove_if([](const OneDice &die) { return die.get_odds_handle() != fair_odds_handle; });
+    ASSERT_EQ(removed, 1);
+    ASSERT_EQ(dice.sum(), 6);
+    ASSERT_FALSE(dice.has_NumPoints(3));
+}
+
+TEST(DiceTest, ParallelRoll)
+{
+    Chance ch[6] = {0, 1, 0, 1, 0, 0};
+    Dice dice(200000);
+    for (size_t i = 70000; i < 70100; ++i)
+        dice[i].set_odds(Odds(ch));
+    Dice other = dice;
+    seed_random(5);
+    dice.roll_parallel(1);
+    seed_random(5);
+    other.roll_parallel(7);
+    for (size_t i = 0; i < dice.get_size(); ++i)
+        ASSERT_EQ(dice.get_values()[i], other.get_values()[i]);
+    for (size_t i = 70000; i < 70100; ++i)
+        ASSERT_TRUE(dice[i].get_value() == 2 || dice[i].get_value() == 4);
+    std::uint64_t expected = 0;
+    for (size_t i = 0; i < dice.get_size(); ++i)
+        expected += dice.get_values()[i];
+    ASSERT_EQ(dice.sum(), expected);
+
+    dice.set_CounterEngine(CounterEngine(3));
+    dice.roll_parallel(3);
+    ASSERT_EQ(dice.get_epoch(), 1);
+    ASSERT_EQ(dice[123456].get_value(), dice.get_roll(123456, 1));
+}
+
+TEST(ReduceTest, SumAndCount)
+{
+    const size_t count = 4 * parallel_reduce_min + 77;
+    Vector<PackedNumPoints> values(count);
+    PackedNumPoints *data = values.get_data();
+    for (size_t i = 0; i < count; ++i)
+        data[i] = static_cast<PackedNumPoints>(i % 7);
+    std::uint64_t expected = 0;
+    size_t expected_counts[7] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        expected += data[i];
+        ++expected_counts[data[i]];
+    }
+    SimdLevel best = get_SimdLevel();
+    for (SimdLevel level : {SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2})
+    {
+        set_SimdLevel(level);
+        ASSERT_EQ(sum_values(data + 3, 1000), sum_values(data + 3, 1000, 1));
+        ASSERT_EQ(sum_values(data, count), expected);
+        size_t counts[7] = {};
+        count_faces(data + 1, count - 1, 6, counts);
+        ++counts[data[0]];
+        for (size_t face = 0; face <= 6; ++face)
+            ASSERT_EQ(counts[face], expected_counts[face]);
+    }
+    set_SimdLevel(best);
+    ASSERT_EQ(sum_values(data, count, 4), expected);
+
+    Dice dice(20000);
+    std::uint64_t dice_sum = 0;
+    for (size_t i = 0; i < dice.get_size(); ++i)
+        dice_sum += dice.get_values()[i];
+    ASSERT_EQ(dice.sum(), dice_sum);
+    ASSERT_GT(dice.sum(), 65535);
+}
+
+TEST(SimulationTest, Sum)
+{
+    Chance ch[6] = {0, 0, 0, 0, 0, 1};
+    Dice dice(3);
+    SimulationResult result = simulate_sum(dice, 600000, 3);
+    ASSERT_EQ(result.trials, 600000);
+    ASSERT_EQ(result.histogram.get_size(), 19);
+    ASSERT_EQ(result.histogram[2], 0);
+    std::uint64_t total = 0;
+    for (std::uint64_t count : result.histogram)
+        total += count;
+    ASSERT_EQ(total, 600000);
+    ASSERT_NEAR(result.histogram[10] / 600000.0, 27.0 / 216, 0.003);
+    ASSERT_NEAR(result.histogram[3] / 600000.0, 1.0 / 216, 0.001);
+
+    dice += OneDice(6, Odds(ch));
+    result = simulate_sum(dice, 1000, 2);
+    ASSERT_EQ(result.histogram[8], 0);
+    ASSERT_GT(result.trials_per_second, 0);
+}
+
+TEST(SimulationTest, Statistic)
+{
+    Chance ch[6] = {1, 0, 0, 0, 0, 1};
+    Dice dice(4);
+    for (size_t i = 0; i < 4; ++i)
+        dice[i].set_odds(Odds(ch));
+    SimulationResult result =
+        simulate(dice, 100000, [](const Dice &trial) { return trial.count_NumPoints(6); }, 4);
+    ASSERT_EQ(result.histogram.get_size(), 5);
+    ASSERT_NEAR(result.histogram[2] / 100000.0, 6.0 / 16, 0.01);
+    ASSERT_THROW(simulate(dice, 10, [](const Dice &) { return std::uint64_t(max_histogram_size); }, 2),
+                 std::out_of_range);
+}
+
+TEST(DistributionTest, Exact)
+{
+    SumDistribution two(Odds(), 2);
+    ASSERT_EQ(two.get_min(), 2);
+    ASSERT_EQ(two.get_max(), 12);
+    ASSERT_NEAR(two.get_pmf(7), 6.0 / 36, 1e-12);
+    ASSERT_NEAR(two.get_cdf(4), 6.0 / 36, 1e-12);
+    ASSERT_EQ(two.get_pmf(13), 0);
+    ASSERT_EQ(two.get_cdf(1), 0);
+    ASSERT_EQ(two.get_cdf(12), 1);
+
+    Chance ch[6] = {0, 1, 0, 1, 0, 0};
+    Dice dice(3);
+    dice += OneDice(2, Odds(ch));
+    SumDistribution mixed(dice);
+    ASSERT_EQ(mixed.get_min(), 5);
+    ASSERT_EQ(mixed.get_max(), 22);
+    ASSERT_NEAR(mixed.get_pmf(5), 0.5 / 216, 1e-12);
+
+    Vector<double> a(100, 0.01), b(200, 0.005);
+    Vector<double> fast = convolve(a, b);
+    ASSERT_EQ(fast.get_size(), 299);
+    for (size_t k = 0; k < fast.get_size(); ++k)
+    {
+        double direct = 0;
+        for (size_t i = 0; i < a.get_size(); ++i)
+            if (k >= i && k - i < b.get_size())
+                direct += a[i] * b[k - i];
+        ASSERT_NEAR(fast[k], direct, 1e-15);
+    }
+
+    SumDistribution large(Odds(), 10000);
+    ASSERT_EQ(large.get_max(), 60000);
+    ASSERT_NEAR(large.get_cdf(34999), 0.5, 0.01);
+    ASSERT_NEAR(large.get_pmf(35000), 1 / std::sqrt(2 * std::acos(-1.0) * 10000 * 35.0 / 12), 1e-5);
+}
+
+TEST(DiceTest, Reroll)
+{
+    Chance ch[6] = {0, 0, 0, 0, 0, 1};
+    Dice dice = Dice(Vector<NumPoints>({1, 1, 1, 1, 1}));
+    dice[3].set_odds(Odds(ch));
+    ASSERT_THROW(dice.reroll(Vector<size_t>({0, 5})), std::out_of_range);
+    ASSERT_EQ(dice.sum(), 5);
+    dice.reroll(Vector<size_t>({3, 1}));
+    ASSERT_EQ(dice[3].get_value(), 6);
+    ASSERT_EQ(dice[0].get_value(), 1);
+    ASSERT_EQ(dice.sum(), 9 + dice[1].get_value());
+
+    ASSERT_EQ(dice.reroll_if([](const OneDice &die) { return die.get_odds_handle() != fair_odds_handle; }), 1);
+    ASSERT_EQ(dice[3].get_value(), 6);
+
+    dice.set_CounterEngine(CounterEngine(8));
+    dice.reroll(Vector<size_t>({4, 0, 4}));
+    ASSERT_EQ(dice.get_epoch(), 1);
+    ASSERT_EQ(dice[4].get_value(), dice.get_roll(4, 1));
+    ASSERT_EQ(dice[0].get_value(), dice.get_roll(0, 1));
+    ASSERT_THROW(dice.get_roll(2, 1), std::invalid_argument);
+    ASSERT_EQ(dice[2].get_value(), 1);
+}
+
+TEST(ParserTest, Dice)
+{
+    std::string text = "4\n1 6 2\t3 \n";
+    Dice dice = parse_Dice(text.data(), text.data() + text.size());
+    ASSERT_EQ(dice.get_size(), 4);
+    ASSERT_EQ(dice.sum(), 12);
+    try
+    {
+        std::string invalid = "3 1 x 2";
+        TextParser parser(invalid);
+        parse_Dice(parser);
+        FAIL();
+    }
+    catch (const ParseError &error)
+    {
+        ASSERT_EQ(error.get_offset(), 4);
+    }
+    std::string bad_value = "2 1 7", short_text = "3 1 2", trailing = "1 1 2";
+    ASSERT_THROW(parse_Dice(bad_value.data(), bad_value.data() + bad_value.size()), ParseError);
+    ASSERT_THROW(parse_Dice(short_text.data(), short_text.data() + short_text.size()), ParseError);
+    ASSERT_THROW(parse_Dice(trailing.data(), trailing.data() + trailing.size()), ParseError);
+    for (std::string digit_text : {"2 0 5 1", "3 1 7 2 3", "2 1 9"})
+    {
+        try
+        {
+            parse_Dice(digit_text.data(), digit_text.data() + digit_text.size());
+            FAIL();
+        }
+        catch (const ParseError &error)
+        {
+            ASSERT_EQ(std::string(error.what()).find("Invalid value!"), 0);
+            ASSERT_EQ(error.get_offset(), digit_text.find_first_of("079"));
+        }
+    }
+
+    std::string one_text = "5 0 0 1 0 0 1", zero_text = "0 0 0 0 0 0";
+    TextParser parser(one_text);
+    OneDice one = parse_OneDice<6>(parser);
+    Chance ch[6] = {0, 0, 1, 0, 0, 1};
+    ASSERT_EQ(one, OneDice(5, Odds(ch)));
+    TextParser zero(zero_text);
+    ASSERT_THROW(parse_Odds<6>(zero), ParseError);
+    ASSERT_THROW(load_Dice("/nonexistent/dice.txt"), std::system_error);
+}
+
+TEST(StorageTest, View)
+{
+    std::string path = testing::TempDir() + "dice_storage_test.bin";
+    NumPoints vals[7] = {1, 6, 3, 3, 5, 2, 6};
+    Dice dice(vals, vals + 7);
+    save_Dice(dice, path);
+    {
+        DiceView view(path);
+        ASSERT_EQ(view.get_size(), 7);
+        ASSERT_EQ(view.sum(), 26);
+        ASSERT_TRUE(view.has_NumPoints(3));
+        ASSERT_FALSE(view.has_NumPoints(4));
+        ASSERT_EQ(view.count_NumPoints(6), 2);
+        ASSERT_EQ(view.get_values()[4], 5);
+        ASSERT_EQ(view[1], OneDice(6));
+        ASSERT_THROW(view[7], std::out_of_range);
+    }
+
+    Chance ch[6] = {0, 1, 0, 0, 0, 3};
+    dice[2].set_odds(Odds(ch));
+    dice[5].set_odds(Odds(ch));
+    save_Dice(dice, path);
+    DiceView view(path);
+    ASSERT_EQ(view[2], OneDice(3, Odds(ch)));
+    ASSERT_EQ(view[3], OneDice(3));
+    Dice loaded = view.to_Dice();
+    ASSERT_EQ(loaded.get_size(), 7);
+    for (size_t i = 0; i < 7; ++i)
+        ASSERT_EQ(static_cast<OneDice>(loaded[i]), view[i]);
+    view.verify();
+
+    {
+        std::fstream patch(path, std::ios::binary | std::ios::in | std::ios::out);
+        DiceFileHeader header;
+        patch.read(reinterpret_cast<char *>(&header), sizeof(header));
+        patch.seekp(static_cast<std::streamoff>(header.values_offset));
+        patch.put(4);
+    }
+    DiceView edited(path);
+    ASSERT_EQ(edited.count_NumPoints(4), 0);
+    ASSERT_THROW(edited.verify(), std::invalid_argument);
+    ASSERT_THROW(edited.to_Dice(), std::invalid_argument);
+
+    save_Dice(Dice(), path);
+    {
+        DiceView empty(path);
+        ASSERT_EQ(empty.get_size(), 0);
+        ASSERT_EQ(empty.sum(), 0);
+        empty.verify();
+        ASSERT_EQ(empty.to_Dice().get_size(), 0);
+    }
+
+    std::ofstream(path, std::ios::binary) << "not a dice file, but long enough to hold a header of the format......."
+                                             "..........................................................";
+    ASSERT_THROW(DiceView bad(path), std::invalid_argument);
+    std::remove(path.c_str());
+}
+
+TEST(ConcurrentTest, DisjointRerolls)
+{
+    const size_t size = 8 * concurrent_shard_size;
+    ConcurrentDice dice(size);
+    std::vector<std::thread> workers;
+    std::atomic<bool> done(false);
+    std::atomic<bool> consistent(true);
+    std::thread reader(
+        [&]()
+        {
+            while (!done.load())
+            {
+                DiceSnapshot snapshot = dice.snapshot();
+                std::uint64_t count = 0, total = 0;
+                for (size_t face = 1; face <= OneDice::faces; ++face)
+                {
+                    count += snapshot.counts[face];
+                    total += snapshot.counts[face] * face;
+                }
+                if (count != size || total != snapshot.sum)
+                    consistent = false;
+            }
+        });
+    for (size_t t = 0; t < 4; ++t)
+        workers.emplace_back(
+            [&dice, t, size]()
+            {
+                std::vector<size_t> indices;
+                for (size_t i = t; i < size; i += 4)
+                    indices.push_back(i);
+                for (int round = 0; round < 20; ++round)
+                {
+                    dice.reroll(indices.data(), indices.data() + indices.size());
+                    dice.reroll(indices[round]);
+                }
+            });
+    for (std::thread &worker : workers)
+        worker.join();
+    done = true;
+    reader.join();
+    ASSERT_TRUE(consistent.load());
+
+    Chance ch[6] = {0, 0, 0, 0, 0, 1};
+    dice.set_odds(5, Odds(ch));
+    ASSERT_EQ(dice.reroll(5), 6);
+    Dice copy = dice.to_Dice();
+    ASSERT_EQ(copy.sum(), dice.sum());
+    ASSERT_EQ(static_cast<OneDice>(copy[5]), dice[5]);
+    ASSERT_EQ(dice[5].get_odds_handle(), dice.get_odds_handle(5));
+    for (size_t i = 6; i < 10; ++i)
+        dice.set_odds(i, Odds(ch));
+    size_t sixes[6] = {4, 6, 7, 8, 9, concurrent_shard_size + 6};
+    dice.reroll(sixes, sixes + 6);
+    for (size_t i = 5; i < 10; ++i)
+        ASSERT_EQ(dice.get_value(i), 6);
+    ASSERT_THROW(dice.reroll(size), std::out_of_range);
+}
+
+TEST(JournalTest, RecordAndRead)
+{
+    std::string path = testing::TempDir() + "dice_journal_test.bin";
+    Dice dice(10);
+    start_roll_journal(path);
+    ASSERT_TRUE(is_roll_journal_active());
+    ASSERT_THROW(start_roll_journal(path), std::logic_error);
+    dice();
+    NumPoints rerolled = dice(3);
+    OneDice one;
+    std::thread worker(
+        []()
+        {
+            for (size_t i = 0; i < 2 * journal_buffer_events; ++i)
+                OneDice();
+        });
+    worker.join();
+    stop_roll_journal();
+    ASSERT_FALSE(is_roll_journal_active());
+    dice();
+
+    const size_t expected = 10 + 1 + 1 + 2 * journal_buffer_events;
+    RollJournalStats stats = get_roll_journal_stats();
+    ASSERT_EQ(stats.recorded, expected);
+    ASSERT_EQ(stats.written, expected);
+
+    RollJournalReader reader(path);
+    ASSERT_EQ(reader.get_size(), expected);
+    std::vector<RollEvent> main_events;
+    const RollEvent *first = std::find_if(reader.get_events(), reader.get_events() + expected,
+                                          [](const RollEvent &event) { return event.index == 0; });
+    for (size_t i = 0; i < reader.get_size(); ++i)
+    {
+        ASSERT_EQ(reader[i].faces, 6);
+        ASSERT_TRUE(reader[i].value >= 1 && reader[i].value <= 6);
+        if (reader[i].thread == first->thread)
+            main_events.push_back(reader[i]);
+    }
+    ASSERT_EQ(main_events.size(), 12);
+    for (size_t i = 0; i < 10; ++i)
+        ASSERT_EQ(main_events[i].index, i);
+    ASSERT_EQ(main_events[10].index, 3);
+    ASSERT_EQ(main_events[10].value, rerolled);
+    ASSERT_EQ(main_events[11].index, journal_no_index);
+    ASSERT_EQ(main_events[11].value, one.get_value());
+    ASSERT_THROW(reader[expected], std::out_of_range);
+    std::remove(path.c_str());
+}
+
+TEST(JournalTest, StopWhileRolling)
+{
+    std::string path = testing::TempDir() + "dice_journal_stop_test.bin";
+    std::atomic<bool> done(false);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < 4; ++t)
+        workers.emplace_back(
+            [&done]()
+            {
+                Dice dice(100);
+                while (!done.load())
+                {
+                    OneDice();
+                    dice();
+                }
+            });
+    for (size_t i = 0; i < 300; ++i)
+    {
+        start_roll_journal(path);
+        std::this_thread::yield();
+        stop_roll_journal();
+    }
+    done = true;
+    for (std::thread &worker : workers)
+        worker.join();
+    ASSERT_FALSE(is_roll_journal_active());
+    RollJournalReader reader(path);
+    ASSERT_EQ(reader.get_size(), get_roll_journal_stats().written);
+    std::remove(path.c_str());
+}
+
+TEST(MomentsTest, Quantiles)
+{
+    OddsMoments fair = Odds().get_moments();
+    ASSERT_DOUBLE_EQ(fair.mean, 3.5);
+    ASSERT_DOUBLE_EQ(fair.variance, 35.0 / 12);
+    ASSERT_NEAR(fair.third, 0, 1e-12);
+    ASSERT_DOUBLE_EQ(fair.fourth, -259.0 / 24);
+    ASSERT_NEAR(normal_quantile(0.975), 1.959963984540054, 1e-12);
+    ASSERT_NEAR(normal_quantile(1e-6), -4.753424308822899, 1e-9);
+    ASSERT_THROW(normal_quantile(1), std::invalid_argument);
+
+    Chance ch[6] = {1, 1, 1, 1, 1, 5};
+    Dice dice(10);
+    for (size_t i = 0; i < 5; ++i)
+        dice[i].set_odds(Odds(ch));
+    dice += OneDice(2, Odds(ch));
+    dice += OneDice(4);
+    OddsMoments loaded = Odds(ch).get_moments();
+    ASSERT_NEAR(dice.mean(), 6 * loaded.mean + 6 * fair.mean, 1e-9);
+    ASSERT_NEAR(dice.variance(), 6 * loaded.variance + 6 * fair.variance, 1e-9);
+    Dice recounted(dice);
+    recounted.remove_if([](const OneDice &) { return false; });
+    ASSERT_NEAR(recounted.get_moments().third, dice.get_moments().third, 1e-9);
+    ASSERT_NEAR(recounted.get_moments().fourth, dice.get_moments().fourth, 1e-9);
+
+    SumDistribution exact(dice);
+    for (double p : {0.01, 0.1, 0.5, 0.9, 0.99})
+    {
+        std::uint64_t sum = exact.get_min();
+        while (exact.get_cdf(sum) < p)
+            ++sum;
+        ASSERT_NEAR(dice.quantile(p), static_cast<double>(sum), 1.5);
+        ASSERT_NEAR(dice.quantile(p, QuantileMethod::normal), static_cast<double>(sum), 2.5);
+    }
+
+    size_t before = dice.get_size();
+    dice -= 6;
+    ASSERT_LT(dice.get_size(), before);
+    Dice rebuilt(dice);
+    rebuilt.remove_if([](const OneDice &) { return false; });
+    ASSERT_NEAR(dice.mean(), rebuilt.mean(), 1e-9);
+    dice -= 1;
+    dice -= 2;
+    dice -= 3;
+    dice -= 4;
+    dice -= 5;
+    ASSERT_EQ(dice.mean(), 0);
+    ASSERT_EQ(dice.quantile(0.5), 0);
+}
+
+TEST(ScoringTest, Patterns)
+{
+    PackedNumPoints full_house[5] = {3, 5, 3, 5, 3};
+    FaceSignature signature = to_FaceSignature(full_house, 5);
+    ASSERT_EQ(score_Pattern(signature, Pattern::pair), 10);
+    ASSERT_EQ(score_Pattern(signature, Pattern::two_pairs), 16);
+    ASSERT_EQ(score_Pattern(signature, Pattern::three_of_a_kind), 19);
+    ASSERT_EQ(score_Pattern(signature, Pattern::four_of_a_kind), 0);
+    ASSERT_EQ(score_Pattern(signature, Pattern::full_house), 25);
+    ASSERT_EQ(score_Pattern(signature, Pattern::chance), 19);
+    ASSERT_EQ(match_Patterns(signature), to_PatternMask(Pattern::pair) | to_PatternMask(Pattern::two_pairs) |
+                                             to_PatternMask(Pattern::three_of_a_kind) |
+                                             to_PatternMask(Pattern::full_house) | to_PatternMask(Pattern::chance));
+
+    NumPoints straight[5] = {2, 5, 4, 3, 6};
+    Dice dice(straight, straight + 5);
+    signature = to_FaceSignature(dice);
+    ASSERT_EQ(signature, to_FaceSignature(dice.get_values(), dice.get_size()));
+    ASSERT_EQ(score_Pattern(signature, Pattern::small_straight), 30);
+    ASSERT_EQ(score_Pattern(signature, Pattern::large_straight), 40);
+    ASSERT_EQ(score_Pattern(signature, Pattern::pair), 0);
+    dice[4] = OneDice(2);
+    ASSERT_EQ(score_Pattern(to_FaceSignature(dice), Pattern::large_straight), 0);
+    ASSERT_EQ(score_Pattern(to_FaceSignature(dice), Pattern::small_straight), 30);
+
+    PackedNumPoints groups[15] = {6, 6, 6, 6, 6, 1, 1, 1, 1, 2, 4, 4, 2, 2, 4};
+    unsigned scores[3];
+    score_groups(groups, 5, 3, Pattern::yahtzee, scores);
+    ASSERT_EQ(scores[0], 50);
+    ASSERT_EQ(scores[1], 0);
+    score_groups(groups, 5, 3, Pattern::four_of_a_kind, scores);
+    ASSERT_EQ(scores[1], 6);
+    PatternMask masks[3];
+    match_groups(groups, 5, 3, masks);
+    ASSERT_TRUE(masks[2] & to_PatternMask(Pattern::full_house));
+    ASSERT_FALSE(masks[0] & to_PatternMask(Pattern::full_house));
+
+    groups[7] = 7;
+    ASSERT_THROW(score_groups(groups, 5, 3, Pattern::chance, scores), std::invalid_argument);
+    ASSERT_THROW(to_FaceSignature(groups, 7), std::length_error);
+    ASSERT_THROW(to_FaceSignature(Dice(7)), std::length_error);
+}
+
+TEST(SolverTest, Yahtzee)
+{
+    RerollSolver solver(5, 2, Pattern::yahtzee, Odds(), 2);
+    double chance = 0;
+    PackedNumPoints hand[5];
+    for (size_t code = 0; code < 7776; ++code)
+    {
+        for (size_t i = 0, rest = code; i < 5; ++i, rest /= 6)
+            hand[i] = static_cast<PackedNumPoints>(rest % 6 + 1);
+        chance += solver.get_value(to_FaceSignature(hand, 5), 2) / 50 / 7776;
+    }
+    ASSERT_NEAR(chance, 0.0460286, 1e-6);
+
+    NumPoints four[5] = {6, 2, 6, 6, 6};
+    Dice dice(four, four + 5);
+    RerollDecision decision = solver.solve(dice, 1);
+    ASSERT_NEAR(decision.expected, 50.0 / 6, 1e-9);
+    ASSERT_EQ(decision.reroll.get_size(), 1);
+    ASSERT_EQ(decision.reroll[0], 1);
+    decision = solver.solve(dice, 0);
+    ASSERT_TRUE(decision.reroll.is_empty());
+    ASSERT_EQ(decision.expected, 0);
+    dice.reroll(decision.reroll);
+
+    RerollSolver straight(5, 1, Pattern::large_straight);
+    NumPoints almost[5] = {1, 2, 3, 4, 4};
+    Dice hand_dice(almost, almost + 5);
+    decision = straight.solve(hand_dice, 1);
+    ASSERT_EQ(decision.reroll.get_size(), 1);
+    ASSERT_NEAR(decision.expected, 40.0 / 6, 1e-9);
+
+    ASSERT_THROW(solver.solve(dice, 3), std::out_of_range);
+    ASSERT_THROW(solver.solve(Dice(4), 1), std::invalid_argument);
+    Chance ch[6] = {1, 1, 1, 1, 1, 2};
+    dice[0].set_odds(Odds(ch));
+    ASSERT_THROW(solver.solve(dice, 1), std::invalid_argument);
+}
+
+TEST(StreamTest, Generators)
+{
+    Chance ch[6] = {0, 1, 0, 0, 0, 1};
+    OneDice dice{Odds(ch)};
+    size_t count = 0;
+    for (NumPoints value : roll_stream(dice, 10000))
+    {
+        ASSERT_TRUE(value == 2 || value == 6);
+        ++count;
+    }
+    ASSERT_EQ(count, 10000);
+
+    std::vector<size_t> sizes;
+    for (RollBatch batch : roll_batches(dice, 2500, 1000))
+    {
+        sizes.push_back(batch.size);
+        for (NumPoints value : batch)
+            ASSERT_TRUE(value == 2 || value == 6);
+    }
+    ASSERT_EQ(sizes, std::vector<size_t>({1000, 1000, 500}));
+    ASSERT_THROW(roll_batches(dice, 10, 0).begin(), std::invalid_argument);
+
+    count = 0;
+    for (NumPoints value : roll_stream(dice))
+        if (++count == 5 || value == 0)
+            break;
+    ASSERT_EQ(count, 5);
+
+    Dice group(3);
+    count = 0;
+    for (const Dice &rolled : roll_stream(group, 100))
+    {
+        ASSERT_EQ(rolled.get_size(), 3);
+        ASSERT_TRUE(rolled.sum() >= 3 && rolled.sum() <= 18);
+        ++count;
+    }
+    ASSERT_EQ(count, 100);
+}
+
+TEST(StreamTest, Backpressure)
+{
+    AsyncRollStream stream(OneDice(), 10000, 100, 1);
+    Vector<NumPoints> batch;
+    size_t total = 0;
+    while (stream.next(batch))
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        for (NumPoints value : batch)
+            ASSERT_TRUE(value >= 1 && value <= 6);
+        total += batch.get_size();
+    }
+    ASSERT_EQ(total, 10000);
+    ASSERT_GT(stream.get_suspensions(), 0);
+    ASSERT_FALSE(stream.next(batch));
+
+    {
+        AsyncRollStream endless(OneDice(), stream_unlimited, 64, 2);
+        ASSERT_TRUE(endless.next(batch));
+        ASSERT_EQ(batch.get_size(), 64);
+    }
+    ASSERT_THROW(AsyncRollStream(OneDice(), 10, 0), std::invalid_argument);
+
+    std::vector<std::unique_ptr<AsyncRollStream>> parked;
+    for (size_t i = 0; i < 16; ++i)
+        parked.push_back(std::make_unique<AsyncRollStream>(OneDice(), 1000, 10, 1));
+    for (std::unique_ptr<AsyncRollStream> &waiting : parked)
+        while (waiting->get_suspensions() == 0)
+            std::this_thread::yield();
+    for (std::unique_ptr<AsyncRollStream> &waiting : parked)
+    {
+        total = 0;
+        while (waiting->next(batch))
+            total += batch.get_size();
+        ASSERT_EQ(total, 1000);
+    }
+}
+
+/*!
+    \brief Сопрограмма потребителя для тестов
+    \details Запускается сразу и сообщает о завершении через done.
+*/
+struct ConsumerTask
+{
+        struct promise_type
+        {
+                ConsumerTask get_return_object() noexcept
+                {
+                    return {};
+                }
+                std::suspend_never initial_suspend() const noexcept
+                {
+                    return {};
+                }
+                std::suspend_never final_suspend() const noexcept
+                {
+                    return {};
+                }
+                void return_void() const noexcept
+                {
+                }
+                void unhandled_exception() const noexcept
+                {
+                    std::terminate();
+                }
+        };
+};
+
+ConsumerTask consume_stream(AsyncRollStream &stream, std::promise<size_t> &done)
+{
+    Vector<NumPoints> batch;
+    size_t total = 0;
+    while (co_await stream.next_async(batch))
+        total += batch.get_size();
+    done.set_value(total);
+}
+
+TEST(StreamTest, AwaitBatches)
+{
+    AsyncRollStream stream(OneDice(), 5000, 64, 1);
+    std::promise<size_t> done;
+    std::future<size_t> total = done.get_future();
+    consume_stream(stream, done);
+    ASSERT_EQ(total.get(), 5000);
+}
@@ -0,0 +1,84 @@
+#include "../src/libs/dice/journal/journal.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+/*!
+    \brief Вывод события
+    \details Выводит время, номер потока, номер кости ("-" для кости вне группы), кол-во граней и значение.
+
+    \param[in] event ссылка на событие.
+*/
+void print_event(const RollEvent &event)
+{
+    std::cout << event.timestamp << ' ' << event.thread << ' ';
+    if (event.index == journal_no_index)
+        std::cout << '-';
+    else
+        std::cout << event.index;
+    std::cout << " d" << event.faces << ' ' << event.value << '\n';
+}
+
+/*!
+    \brief Вывод сводки
+    \details Выводит кол-во событий, потоков и кол-во выпадений каждого значения для каждого вида костей.
+
+    \param[in] reader ссылка на журнал.
+*/
+void print_summary(const RollJournalReader &reader)
+{
+    std::map<std::uint16_t, std::vector<std::uint64_t>> histograms;
+    std::map<std::uint32_t, std::uint64_t> threads;
+    for (size_t i = 0; i < reader.get_size(); ++i)
+    {
+        const RollEvent &event = reader[i];
+        std::vector<std::uint64_t> &histogram = histograms[event.faces];
+        if (histogram.size() <= event.value)
+            histogram.resize(event.value + 1, 0);
+        ++histogram[event.value];
+        ++threads[event.thread];
+    }
+    std::cout << reader.get_size() << " rolls from " << threads.size() << " threads" << std::endl;
+    for (const auto &histogram : histograms)
+    {
+        std::cout << 'd' << histogram.first << ':';
+        for (size_t value = 1; value < histogram.second.size(); ++value)
+            std::cout << ' ' << value << '=' << histogram.second[value];
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool summary = argc == 3 && std::strcmp(argv[1], "--summary") == 0;
+    if (argc != 2 && !summary)
+    {
+        std::cerr << "Usage: replay [--summary] journal" << std::endl;
+        return 2;
+    }
+    try
+    {
+        RollJournalReader reader(argv[argc - 1]);
+        if (summary)
+            print_summary(reader);
+        else
+            for (size_t i = 0; i < reader.get_size(); ++i)
+                print_event(reader[i]);
+    }
+    catch (const std::system_error &error)
+    {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    catch (const std::invalid_argument &error)
+    {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
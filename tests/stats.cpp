@@ -0,0 +1,202 @@
+#include "../src/libs/dice/dice.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr double significance = 1e-6;        ///< Уровень значимости критериев
+constexpr size_t stats_block = 4096;         ///< Кол-во граней, генерируемых потоком за один раз
+constexpr std::uint64_t default_samples = 1000000000; ///< Кол-во бросков по умолчанию
+
+/*!
+    \brief Результат проверки
+    \details Частоты граней, время генерации и статистики критериев.
+*/
+struct StatsResult
+{
+        std::vector<std::uint64_t> counts;
+        double seconds = 0;
+        double chi_square = 0;
+        size_t freedom = 0;
+        double p_value = 1;
+        double ks = 0;
+        double ks_limit = 0;
+        bool impossible_face = false;
+};
+
+/*!
+    \brief Уровень значимости критерия хи-квадрат
+    \details Вычисляет вероятность превысить значение chi_square для распределения хи-квадрат с freedom степенями
+   свободы по приближению Уилсона-Хилферти.
+
+    \param[in] chi_square значение статистики.
+    \param[in] freedom кол-во степеней свободы.
+
+    \return Вероятность превысить chi_square.
+*/
+double chi_square_p_value(const double chi_square, const size_t freedom)
+{
+    if (freedom == 0)
+        return 1;
+    double k = static_cast<double>(freedom);
+    double z = (std::cbrt(chi_square / k) - (1 - 2 / (9 * k))) / std::sqrt(2 / (9 * k));
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/*!
+    \brief Проверка распределения граней
+    \details Бросает samples костей с шансами odds в threads потоках, каждый поток ведёт свою гистограмму. Затем
+   сравнивает частоты с ожидаемыми критерием хи-квадрат и критерием Колмогорова-Смирнова.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] odds ссылка на шансы выпадения граней.
+    \param[in] samples кол-во бросков.
+    \param[in] threads кол-во потоков.
+
+    \return Результат проверки.
+*/
+template <size_t Faces>
+StatsResult check_odds(const BasicOdds<Faces> &odds, const std::uint64_t samples, const size_t threads)
+{
+    OddsHandle handle = OddsRegistry<Faces>::intern(odds);
+    std::vector<std::vector<std::uint64_t>> histograms(threads, std::vector<std::uint64_t>(Faces + 1, 0));
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; ++t)
+        workers.emplace_back(
+            [&histograms, handle, t, samples, threads]()
+            {
+                std::vector<std::uint64_t> &histogram = histograms[t];
+                std::uint64_t left = samples / threads + (t < samples % threads ? 1 : 0);
+                NumPoints faces[stats_block];
+                while (left > 0)
+                {
+                    size_t block = static_cast<size_t>(std::min<std::uint64_t>(left, stats_block));
+                    random_odds<Faces>(handle, faces, block);
+                    for (size_t i = 0; i < block; ++i)
+                        ++histogram[faces[i]];
+                    left -= block;
+                }
+            });
+    for (std::thread &worker : workers)
+        worker.join();
+    StatsResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    result.counts.assign(Faces + 1, 0);
+    for (const std::vector<std::uint64_t> &histogram : histograms)
+        for (size_t face = 0; face <= Faces; ++face)
+            result.counts[face] += histogram[face];
+
+    double total = 0;
+    for (size_t i = 0; i < Faces; ++i)
+        total += odds.get_odds(i);
+    double n = static_cast<double>(samples);
+    double expected_cdf = 0, actual_cdf = 0;
+    size_t possible = 0;
+    result.impossible_face = result.counts[0] != 0;
+    for (size_t face = 1; face <= Faces; ++face)
+    {
+        double p = odds.get_odds(face - 1) / total;
+        double observed = static_cast<double>(result.counts[face]);
+        if (p == 0)
+            result.impossible_face = result.impossible_face || observed != 0;
+        else
+        {
+            double expected = n * p;
+            result.chi_square += (observed - expected) * (observed - expected) / expected;
+            ++possible;
+        }
+        expected_cdf += p;
+        actual_cdf += observed / n;
+        result.ks = std::max(result.ks, std::abs(actual_cdf - expected_cdf));
+    }
+    result.freedom = possible > 0 ? possible - 1 : 0;
+    result.p_value = chi_square_p_value(result.chi_square, result.freedom);
+    result.ks_limit = std::sqrt(-std::log(significance / 2) / (2 * n));
+    return result;
+}
+
+/*!
+    \brief Вывод результата проверки
+    \details Выводит скорость генерации и статистики критериев.
+
+    \param[in] name название проверки.
+    \param[in] samples кол-во бросков.
+    \param[in] result ссылка на результат проверки.
+
+    \return True если распределение согласуется с шансами. Иначе False.
+*/
+bool report(const std::string &name, const std::uint64_t samples, const StatsResult &result)
+{
+    bool passed = !result.impossible_face && result.p_value > significance && result.ks < result.ks_limit;
+    std::cout << name << ": " << samples << " samples, " << result.seconds << " s, "
+              << samples / result.seconds << " samples/s, chi2 = " << result.chi_square << " (df = " << result.freedom
+              << ", p = " << result.p_value << "), KS = " << result.ks << " (limit " << result.ks_limit << ")"
+              << (result.impossible_face ? ", impossible face drawn" : "") << (passed ? " OK" : " FAILED")
+              << std::endl;
+    return passed;
+}
+
+/*!
+    \brief Проверка шансов на всех наборах инструкций
+    \details Проверяет распределение граней для каждого доступного набора векторных инструкций.
+
+    \tparam Faces кол-во граней кости.
+
+    \param[in] name название шансов.
+    \param[in] odds ссылка на шансы выпадения граней.
+    \param[in] samples кол-во бросков.
+    \param[in] threads кол-во потоков.
+
+    \return True если все проверки пройдены. Иначе False.
+*/
+template <size_t Faces>
+bool check_levels(const std::string &name, const BasicOdds<Faces> &odds, const std::uint64_t samples,
+                  const size_t threads)
+{
+    static const char *level_names[] = {"scalar", "sse2", "avx2"};
+    set_SimdLevel(SimdLevel::avx2);
+    SimdLevel best = get_SimdLevel();
+    bool passed = true;
+    for (int level = 0; level <= static_cast<int>(best); ++level)
+    {
+        set_SimdLevel(static_cast<SimdLevel>(level));
+        passed = report(name + " " + level_names[level], samples, check_odds(odds, samples, threads)) && passed;
+    }
+    set_SimdLevel(best);
+    return passed;
+}
+
+int main(int argc, char **argv)
+{
+    std::uint64_t samples = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : default_samples;
+    size_t threads =
+        argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::max<size_t>(1, std::thread::hardware_concurrency());
+    if (samples == 0 || threads == 0)
+    {
+        std::cerr << "Usage: stats [samples] [threads]" << std::endl;
+        return 2;
+    }
+    seed_random(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    Chance weighted6[6] = {1, 2, 3, 4, 5, 6};
+    Chance loaded6[6] = {0, 1, 0, 0, 0, 3};
+    Chance weighted100[100];
+    for (size_t i = 0; i < 100; ++i)
+        weighted100[i] = static_cast<Chance>(i + 1);
+
+    bool passed = true;
+    passed = check_levels("d6 fair", BasicOdds<6>(), samples, threads) && passed;
+    passed = check_levels("d6 weighted", BasicOdds<6>(weighted6), samples, threads) && passed;
+    passed = check_levels("d6 loaded", BasicOdds<6>(loaded6), samples, threads) && passed;
+    passed = check_levels("d20 fair", BasicOdds<20>(), samples, threads) && passed;
+    passed = check_levels("d100 weighted", BasicOdds<100>(weighted100), samples, threads) && passed;
+    return passed ? 0 : 1;
+}